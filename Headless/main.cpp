@@ -0,0 +1,65 @@
+/*
+Headless match runner
+
+Runs AI matches with no window and no GL context, as fast as the CPU allows, and reports the
+simulation throughput in ticks per second. Usage:
+
+	Headless [maxTicks] [matches] [workers]
+
+The enemy tanks are driven by the AI; a match ends when it is decided or after `maxTicks`.
+Matches are spread over `workers` pinned threads (default: one per hardware thread).
+Heap allocations made while the matches run are reported per simulation phase.
+*/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "cb/MatchHost.h"
+#include "cb/AllocCounter.h"
+
+using namespace cb;
+
+const unsigned long long DEFAULT_MAX_TICKS = 1000000;
+const size_t ARENA_BYTES_PER_WORLD = 1 << 20;
+
+int main(int argc, char *argv[]) {
+	try {
+		unsigned long long maxTicks = DEFAULT_MAX_TICKS;
+		unsigned matches = 1;
+		unsigned workers = 0;
+		if (argc > 1)
+			maxTicks = std::strtoull(argv[1], NULL, 10);
+		if (argc > 2)
+			matches = (unsigned)std::strtoul(argv[2], NULL, 10);
+		if (argc > 3)
+			workers = (unsigned)std::strtoul(argv[3], NULL, 10);
+		if (maxTicks == 0 || matches == 0)
+			throw std::runtime_error("maxTicks and matches must be positive numbers");
+
+		MatchHost host(workers, ARENA_BYTES_PER_WORLD);
+		AllocCounts before = allocationCounts();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::vector<MatchResult> results = host.run(matches, maxTicks);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		unsigned long long ticks = 0;
+		for (size_t i = 0; i < results.size(); i++) {
+			ticks += results[i].ticks;
+		}
+		std::cout << "matches: " << matches << " on " << host.workerCount() << " workers" << std::endl;
+		std::cout << "ticks: " << ticks << std::endl;
+		std::cout << "wall seconds: " << seconds << std::endl;
+		std::cout << "ticks per second: " << (seconds > 0 ? ticks / seconds : 0) << std::endl;
+		std::cout << "first match player health: " << results[0].playerHealth << ", score: " << results[0].score << std::endl;
+		std::cout << "heap allocations while running:" << std::endl;
+		reportAllocations(std::cout, allocationCounts().since(before));
+	}
+	catch (const std::exception& e) {
+		std::cerr << "ERROR: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
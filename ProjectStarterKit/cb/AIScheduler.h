@@ -0,0 +1,116 @@
+#ifndef AISCHEDULER_H
+#define AISCHEDULER_H
+#include "Arena.h"
+#include "EntityStore.h"
+
+namespace cb {
+
+	// how often an AI tank thinks; tanks in a fight think every tick, the rest less often
+	enum AILod {
+		AI_LOD_COMBAT,
+		AI_LOD_NEAR,
+		AI_LOD_FAR,
+		AI_LOD_COUNT
+	};
+
+	// what an AI tank decided the last time it thought; it keeps doing this until it thinks again
+	struct AIOrder {
+		float turn;		// body yaw change per tick
+		float throttle;	// 1 drives forward, -1 backs up, 0 stands
+		float aimRight, aimUp;	// turret angles it traverses towards
+		bool fire;		// the target was in range
+		unsigned char action;	// the AIAction it picked
+	};
+
+	/*
+	Level-of-detail scheduler for AI thinking
+
+	Slot i is the i-th AI tank. Each slot keeps the tick it next thinks on, picked from its LOD
+	interval and its slot number so tanks of the same LOD are spread evenly over the ticks of
+	that interval instead of all thinking on the same one. `schedule` hands out at most `budget`
+	due slots per tick and resumes after the last one it handed out, so with more tanks due than
+	the budget allows they wait a tick or two in turn and the cost of a tick stays flat.
+
+	The columns are written by the thinking slot only, so slots can think in parallel.
+	*/
+	class AIScheduler {
+	public:
+		AIScheduler(unsigned int thinkBudget, Arena* arena = NULL) :
+			budget(thinkBudget),
+			orders(ArenaAllocator<AIOrder>(arena)),
+			cursor(0),
+			nextThink(ArenaAllocator<unsigned int>(arena)),
+			combatUntil(ArenaAllocator<unsigned int>(arena)),
+			lod(ArenaAllocator<unsigned char>(arena))
+		{}
+		void reserve(size_t n) {
+			nextThink.reserve(n);
+			combatUntil.reserve(n);
+			lod.reserve(n);
+			orders.reserve(n);
+		}
+		// adds a slot that thinks on the first tick after `tick`
+		unsigned int add(unsigned int tick) {
+			AIOrder idle = { 0, 0, 0, 0, false, 0 };
+			nextThink.push_back(tick + 1);
+			combatUntil.push_back(tick);
+			lod.push_back(AI_LOD_FAR);
+			orders.push_back(idle);
+			return (unsigned int)(nextThink.size() - 1);
+		}
+		size_t size() const { return nextThink.size(); }
+
+		// writes up to `budget` slots due on `tick` to `due`, in slot order from where the last call stopped
+		size_t schedule(unsigned int tick, unsigned int* due) {
+			size_t n = nextThink.size();
+			size_t count = 0;
+			if (n == 0)
+				return 0;
+			if (cursor >= n)
+				cursor = 0;
+			for (size_t k = 0; k < n; k++) {
+				size_t slot = cursor + k < n ? cursor + k : cursor + k - n;
+				if ((int)(tick - nextThink[slot]) < 0)
+					continue;
+				due[count++] = (unsigned int)slot;
+				if (count == budget) {
+					cursor = slot + 1;
+					break;
+				}
+			}
+			return count;
+		}
+		// files the next think of `slot`, which just thought on `tick` at `level`
+		void thought(unsigned int slot, unsigned int tick, AILod level) {
+			unsigned int interval = ticksBetweenThinks(level);
+			lod[slot] = (unsigned char)level;
+			nextThink[slot] = tick + interval - (tick + slot) % interval;
+		}
+		// the slot took part in a fight: it thinks next tick and stays at combat LOD for `ticks`
+		void alert(unsigned int slot, unsigned int tick, unsigned int ticks) {
+			if ((int)(nextThink[slot] - (tick + 1)) > 0)
+				nextThink[slot] = tick + 1;
+			combatUntil[slot] = tick + ticks;
+		}
+		bool inCombat(unsigned int slot, unsigned int tick) const {
+			return (int)(combatUntil[slot] - tick) > 0;
+		}
+		AILod level(unsigned int slot) const { return (AILod)lod[slot]; }
+
+		unsigned int budget;	// most slots that think in one tick
+		Column<AIOrder> orders;
+
+	private:
+		static unsigned int ticksBetweenThinks(AILod level) {
+			static const unsigned int intervals[AI_LOD_COUNT] = { 1, 4, 16 };
+			return intervals[level];
+		}
+
+		size_t cursor;
+		Column<unsigned int> nextThink;
+		Column<unsigned int> combatUntil;
+		Column<unsigned char> lod;
+	};
+
+}
+#endif
@@ -0,0 +1,100 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace cb;
+
+// zero-initialized before any constructor runs, so allocations made during static init count too
+static std::atomic<unsigned long long> gAllocations[PHASE_COUNT];
+static std::atomic<unsigned long long> gBytes[PHASE_COUNT];
+static thread_local AllocPhase tPhase = PHASE_OTHER;
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = { "other", "update", "ai", "projectiles", "render" };
+
+static void* CountedAllocate(size_t size) {
+	gAllocations[tPhase].fetch_add(1, std::memory_order_relaxed);
+	gBytes[tPhase].fetch_add(size, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new(size_t size) {
+	void* p = CountedAllocate(size);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+void* operator new[](size_t size) {
+	void* p = CountedAllocate(size);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return CountedAllocate(size);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return CountedAllocate(size);
+}
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+// sized deletes come from C++14 compilers; they free the same way
+void operator delete(void* p, std::size_t) noexcept {
+	operator delete(p);
+}
+void operator delete[](void* p, std::size_t) noexcept {
+	operator delete[](p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	std::free(p);
+}
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	std::free(p);
+}
+
+AllocCount AllocCounts::total() const {
+	AllocCount sum = { 0, 0 };
+	for (int i = 0; i < PHASE_COUNT; i++) {
+		sum.allocations += phase[i].allocations;
+		sum.bytes += phase[i].bytes;
+	}
+	return sum;
+}
+
+AllocCounts AllocCounts::since(const AllocCounts& earlier) const {
+	AllocCounts d;
+	for (int i = 0; i < PHASE_COUNT; i++) {
+		d.phase[i].allocations = phase[i].allocations - earlier.phase[i].allocations;
+		d.phase[i].bytes = phase[i].bytes - earlier.phase[i].bytes;
+	}
+	return d;
+}
+
+AllocCounts cb::allocationCounts() {
+	AllocCounts counts;
+	for (int i = 0; i < PHASE_COUNT; i++) {
+		counts.phase[i].allocations = gAllocations[i].load(std::memory_order_relaxed);
+		counts.phase[i].bytes = gBytes[i].load(std::memory_order_relaxed);
+	}
+	return counts;
+}
+
+void cb::reportAllocations(std::ostream& out, const AllocCounts& counts) {
+	for (int i = 0; i < PHASE_COUNT; i++) {
+		out << "  " << PHASE_NAMES[i] << ": " << counts.phase[i].allocations << " allocations, "
+			<< counts.phase[i].bytes << " bytes" << std::endl;
+	}
+}
+
+AllocPhaseScope::AllocPhaseScope(AllocPhase phase) {
+	previous = tPhase;
+	tPhase = phase;
+}
+
+AllocPhaseScope::~AllocPhaseScope() {
+	tPhase = previous;
+}
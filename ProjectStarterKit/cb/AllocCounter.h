@@ -0,0 +1,57 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+#include <cstddef>
+#include <ostream>
+
+namespace cb {
+
+	// parts of a frame that heap allocations are charged to
+	enum AllocPhase {
+		PHASE_OTHER,
+		PHASE_UPDATE,
+		PHASE_AI,
+		PHASE_PROJECTILES,
+		PHASE_RENDER,
+		PHASE_COUNT
+	};
+
+	struct AllocCount {
+		unsigned long long allocations;
+		unsigned long long bytes;
+	};
+
+	// allocations made so far, per phase
+	struct AllocCounts {
+		AllocCount phase[PHASE_COUNT];
+
+		AllocCount total() const;
+		// what was allocated between `earlier` and this
+		AllocCounts since(const AllocCounts& earlier) const;
+	};
+
+	/*
+	Heap allocation counter
+
+	AllocCounter.cpp replaces the global operator new, so every allocation of the program is
+	counted against the phase its thread is in. Counters are shared by all threads and only
+	touched when something allocates, which the simulation and the renderer should not do once
+	a match is running.
+	*/
+	AllocCounts allocationCounts();
+	void reportAllocations(std::ostream& out, const AllocCounts& counts);
+
+	// charges this thread's allocations to `phase` until the scope ends
+	class AllocPhaseScope {
+	public:
+		explicit AllocPhaseScope(AllocPhase phase);
+		~AllocPhaseScope();
+
+	private:
+		AllocPhase previous;
+
+		AllocPhaseScope(const AllocPhaseScope&);
+		const AllocPhaseScope& operator=(const AllocPhaseScope&);
+	};
+
+}
+#endif
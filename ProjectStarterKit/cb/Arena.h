@@ -0,0 +1,92 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+
+namespace cb {
+
+	/*
+	Fixed-size bump allocator
+
+	Hands out memory from one block by moving an offset forward. Individual frees are no-ops;
+	everything is released at once by `reset` or when the arena is destroyed. The block is
+	allocated by whichever thread constructs the arena, so the pages end up local to it, or
+	carved out of a parent arena, in which case it lives as long as the parent's.
+	*/
+	class Arena {
+	public:
+		explicit Arena(size_t bytes, Arena* parent = NULL) {
+			owner = parent == NULL;
+			base = static_cast<char*>(owner ? ::operator new(bytes) : parent->allocate(bytes, BLOCK_ALIGN));
+			cap = bytes;
+			offset = 0;
+		}
+		~Arena() {
+			if (owner)
+				::operator delete(base);
+		}
+		void* allocate(size_t bytes, size_t align) {
+			size_t start = (offset + align - 1) & ~(align - 1);
+			if (start + bytes > cap)
+				throw std::runtime_error("Arena out of memory");
+			offset = start + bytes;
+			return base + start;
+		}
+		void reset() { offset = 0; }
+		// releases everything allocated since `used()` returned `mark`
+		void rewind(size_t mark) {
+			if (mark < offset)
+				offset = mark;
+		}
+		size_t used() const { return offset; }
+		size_t capacity() const { return cap; }
+
+	private:
+		static const size_t BLOCK_ALIGN = 64;
+
+		char* base;
+		size_t cap;
+		size_t offset;
+		bool owner;
+
+		//arenas own their block, so they can not be copied
+		Arena(const Arena&);
+		const Arena& operator=(const Arena&);
+	};
+
+	/*
+	Standard allocator that carves its memory from an `Arena`
+
+	With no arena it falls back to the global heap, so containers using it behave like normal
+	containers until they are given an arena.
+	*/
+	template <typename T>
+	class ArenaAllocator {
+	public:
+		typedef T value_type;
+
+		ArenaAllocator(Arena* a = NULL) : arena(a) {}
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+		T* allocate(size_t n) {
+			if (arena)
+				return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+		void deallocate(T* p, size_t) {
+			if (!arena)
+				::operator delete(p);
+		}
+
+		Arena* arena;
+	};
+
+	template <typename T, typename U>
+	bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena == b.arena; }
+	template <typename T, typename U>
+	bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena != b.arena; }
+
+}
+#endif
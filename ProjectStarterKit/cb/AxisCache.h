@@ -0,0 +1,56 @@
+#ifndef AXISCACHE_H
+#define AXISCACHE_H
+
+namespace cb {
+
+	/*
+	Last separating axis seen for each pair of boxes
+
+	Boxes move a few hundredths of a unit per tick, so the axis that separated a pair last tick
+	almost always separates it again; trying it first settles most pairs with one axis test.
+	The table is direct mapped and small: a pair that collides with another for its slot just
+	loses its hint, which only costs the full test again, never a wrong answer.
+	*/
+	class AxisCache {
+	public:
+		static const unsigned char NONE = 0xFF;
+
+		AxisCache() {
+			clear();
+		}
+		void clear() {
+			for (unsigned int i = 0; i < SIZE; i++) {
+				entries[i].a = 0xFFFFFFFF;
+				entries[i].b = 0xFFFFFFFF;
+				entries[i].axis = NONE;
+			}
+		}
+		// cached axis id for the pair, or NONE
+		unsigned char get(unsigned int a, unsigned int b) const {
+			const Entry& e = entries[slot(a, b)];
+			return (e.a == a && e.b == b) ? e.axis : NONE;
+		}
+		void set(unsigned int a, unsigned int b, unsigned char axis) {
+			Entry& e = entries[slot(a, b)];
+			e.a = a;
+			e.b = b;
+			e.axis = axis;
+		}
+
+	private:
+		static const unsigned int SIZE = 1024;
+
+		struct Entry {
+			unsigned int a, b;
+			unsigned char axis;
+		};
+
+		static unsigned int slot(unsigned int a, unsigned int b) {
+			return (a * 2654435761u ^ b * 40503u) & (SIZE - 1);
+		}
+
+		Entry entries[SIZE];
+	};
+
+}
+#endif
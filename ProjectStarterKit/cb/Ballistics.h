@@ -0,0 +1,89 @@
+#ifndef BALLISTICS_H
+#define BALLISTICS_H
+#include "Transform.h"
+#include "ObbBatch.h"
+#include <cmath>
+#include <algorithm>
+
+namespace cb {
+
+	/*
+	Closed-form flight of a shell: origin + velocity*t - (0, gravity*t^2/2, 0)
+
+	Horizontal motion is a straight line and height a downward parabola, which is what lets
+	impacts with the ground and with upright boxes be solved exactly at fire time.
+	*/
+	struct Trajectory {
+		glm::vec3 origin;
+		glm::vec3 velocity;
+		float gravity;
+
+		Trajectory(glm::vec3 o, glm::vec3 v, float g) : origin(o), velocity(v), gravity(g) {}
+
+		glm::vec3 at(float t) const {
+			return origin + velocity * t - glm::vec3(0, 0.5f * gravity * t * t, 0);
+		}
+		/*
+		Times the path passes height `h` going up and coming down. Returns false when it never
+		gets that high; `up` is negative when the shell started above `h`.
+		*/
+		bool crossings(float h, float& up, float& down) const {
+			float a = 0.5f * gravity, b = -velocity.y, c = h - origin.y;
+			float disc = b * b - 4 * a * c;
+			if (disc < 0)
+				return false;
+			float root = std::sqrt(disc);
+			up = (-b - root) / (2 * a);
+			down = (-b + root) / (2 * a);
+			return true;
+		}
+		// time the path comes down through height `h`, or -1 when it never gets that high
+		float descendingTo(float h) const {
+			float up, down;
+			return crossings(h, up, down) ? down : -1;
+		}
+		/*
+		First time in [0, tEnd] the path is inside `box`, or -1 when it stays outside
+
+		Only for upright (yaw-only) boxes: the XZ faces clip the straight horizontal line, then
+		the height interval is clipped against the parabola.
+		*/
+		float enters(const Obb& box, float tEnd) const {
+			glm::vec3 rel = origin - box.center;
+			float t0 = 0, t1 = tEnd;
+			for (int k = 0; k < 3; k += 2) {
+				float p = glm::dot(rel, box.axis[k]);
+				float w = glm::dot(velocity, box.axis[k]);
+				float h = box.half[k];
+				if (std::fabs(w) < 1e-9f) {
+					if (std::fabs(p) > h)
+						return -1;
+					continue;
+				}
+				float ta = (-h - p) / w, tb = (h - p) / w;
+				if (ta > tb)
+					std::swap(ta, tb);
+				t0 = std::max(t0, ta);
+				t1 = std::min(t1, tb);
+				if (t0 > t1)
+					return -1;
+			}
+			// above the bottom face only between the two crossings of it
+			float up, down;
+			if (!crossings(box.center.y - box.half.y, up, down))
+				return -1;
+			t0 = std::max(t0, up);
+			t1 = std::min(t1, down);
+			if (t0 > t1)
+				return -1;
+			// below the top face everywhere except between its crossings
+			float top = box.center.y + box.half.y;
+			if (at(t0).y <= top)
+				return t0;
+			float topDown = descendingTo(top);
+			return (topDown >= t0 && topDown <= t1) ? topDown : -1;
+		}
+	};
+
+}
+#endif
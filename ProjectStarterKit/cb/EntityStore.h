@@ -0,0 +1,198 @@
+#ifndef ENTITYSTORE_H
+#define ENTITYSTORE_H
+#include "Transform.h"
+#include "Arena.h"
+#include <stdexcept>
+#include <vector>
+
+namespace cb {
+
+	struct ModelAsset;
+	typedef unsigned int EntityId;
+	const EntityId NO_PARENT = 0xFFFFFFFF;
+
+	// one component array of a pool; lives in the owning world's arena when it has one
+	template <typename T>
+	using Column = std::vector<T, ArenaAllocator<T> >;
+
+	/*
+	Dense structure-of-arrays pool of boxes
+
+	Every entity is one slot across all of the arrays below, so simulation and rendering walk
+	each component linearly instead of chasing pointers to individually allocated instances.
+	`position` is the logical position used for movement, `center`/`Ax`/`Ay`/`Az` are the
+	oriented box derived from `transform` for collision tests, and `size` holds the half-extents.
+	`previousTransform` is the world matrix as of the previous simulation tick, so rendering can
+	interpolate between the last two ticks.
+
+	Entities can also form a hierarchy: an entity with a `parent` keeps its placement as a rigid
+	`local` pose relative to the parent's `pose`, and `resolveTransforms` turns local poses into
+	world poses and matrices in one pass. Parents are always created before their children, so
+	walking the slots in order visits every parent first, and a moved parent drags its whole
+	subtree along. Scale is applied per entity from `size` and never inherited. Pools that write
+	`transform` directly (crates, shells) just never call `resolveTransforms`.
+	*/
+	class EntityStore {
+	public:
+		EntityStore(Arena* arena = NULL) :
+			asset(ArenaAllocator<ModelAsset*>(arena)),
+			position(ArenaAllocator<glm::vec3>(arena)),
+			yaw(ArenaAllocator<float>(arena)),
+			size(ArenaAllocator<glm::vec3>(arena)),
+			transform(ArenaAllocator<glm::mat4>(arena)),
+			previousTransform(ArenaAllocator<glm::mat4>(arena)),
+			center(ArenaAllocator<glm::vec3>(arena)),
+			Ax(ArenaAllocator<glm::vec3>(arena)),
+			Ay(ArenaAllocator<glm::vec3>(arena)),
+			Az(ArenaAllocator<glm::vec3>(arena)),
+			parent(ArenaAllocator<EntityId>(arena)),
+			local(ArenaAllocator<glm::mat4>(arena)),
+			pose(ArenaAllocator<glm::mat4>(arena)),
+			poseFlags(ArenaAllocator<unsigned char>(arena))
+		{}
+		// `p` is relative to `up` when one is given, which has to be created already
+		EntityId create(ModelAsset* a, glm::vec3 p, glm::vec3 s, EntityId up = NO_PARENT) {
+			if (up != NO_PARENT && up >= asset.size())
+				throw std::runtime_error("EntityStore parent has to be created before its children");
+			asset.push_back(a);
+			position.push_back(p);
+			yaw.push_back(0);
+			size.push_back(s);
+			transform.push_back(translate(p.x, p.y, p.z)*scale(s.x, s.y, s.z));
+			previousTransform.push_back(transform.back());
+			center.push_back(p);
+			Ax.push_back(glm::vec3(1, 0, 0));
+			Ay.push_back(glm::vec3(0, 1, 0));
+			Az.push_back(glm::vec3(0, 0, 1));
+			parent.push_back(up);
+			local.push_back(translate(p.x, p.y, p.z));
+			pose.push_back(local.back());
+			poseFlags.push_back(up != NO_PARENT ? POSE_DIRTY : 0);
+			return (EntityId)(asset.size() - 1);
+		}
+		// O(1) unordered removal: the last entity moves into `id`'s slot. Returns the slot the
+		// moved entity came from (equal to `id` when `id` was the last one). Only for pools
+		// without a hierarchy, since it reorders slots.
+		EntityId swapRemove(EntityId id) {
+			EntityId last = (EntityId)(asset.size() - 1);
+			if (id != last) {
+				asset[id] = asset[last];
+				position[id] = position[last];
+				yaw[id] = yaw[last];
+				size[id] = size[last];
+				transform[id] = transform[last];
+				previousTransform[id] = previousTransform[last];
+				center[id] = center[last];
+				Ax[id] = Ax[last];
+				Ay[id] = Ay[last];
+				Az[id] = Az[last];
+				parent[id] = parent[last];
+				local[id] = local[last];
+				pose[id] = pose[last];
+				poseFlags[id] = poseFlags[last];
+			}
+			asset.pop_back();
+			position.pop_back();
+			yaw.pop_back();
+			size.pop_back();
+			transform.pop_back();
+			previousTransform.pop_back();
+			center.pop_back();
+			Ax.pop_back();
+			Ay.pop_back();
+			Az.pop_back();
+			parent.pop_back();
+			local.pop_back();
+			pose.pop_back();
+			poseFlags.pop_back();
+			return last;
+		}
+		void reserve(size_t n) {
+			asset.reserve(n);
+			position.reserve(n);
+			yaw.reserve(n);
+			size.reserve(n);
+			transform.reserve(n);
+			previousTransform.reserve(n);
+			center.reserve(n);
+			Ax.reserve(n);
+			Ay.reserve(n);
+			Az.reserve(n);
+			parent.reserve(n);
+			local.reserve(n);
+			pose.reserve(n);
+			poseFlags.reserve(n);
+		}
+		// places `id` relative to its parent (or the world); takes effect in `resolveTransforms`
+		void setLocal(EntityId id, const glm::mat4& m) {
+			local[id] = m;
+			poseFlags[id] |= POSE_DIRTY;
+		}
+		// `id` jumped rather than moved, so its next resolved matrix is not interpolated from the old one
+		void teleport(EntityId id) {
+			poseFlags[id] |= POSE_DIRTY | POSE_TELEPORTED;
+		}
+		// brings the world pose and matrix of every entity whose local pose, or any ancestor's, changed up to date
+		void resolveTransforms() {
+			for (size_t i = 0; i < asset.size(); i++) {
+				EntityId up = parent[i];
+				if (up != NO_PARENT)
+					poseFlags[i] |= poseFlags[up] & (POSE_DIRTY | POSE_TELEPORTED);
+				if (!(poseFlags[i] & POSE_DIRTY))
+					continue;
+				glm::mat4& world = pose[i];
+				world = up != NO_PARENT ? pose[up] * local[i] : local[i];
+				glm::mat4& m = transform[i];
+				const glm::vec3& s = size[i];
+				m[0] = world[0] * s.x;
+				m[1] = world[1] * s.y;
+				m[2] = world[2] * s.z;
+				m[3] = world[3];
+				position[i] = glm::vec3(world[3]);
+				if (poseFlags[i] & POSE_TELEPORTED)
+					previousTransform[i] = m;
+			}
+			// children read their parent's flags above, so they are only cleared once all are done
+			for (size_t i = 0; i < poseFlags.size(); i++)
+				poseFlags[i] = 0;
+		}
+		// rebuilds the collision box of `id` from the columns of its world matrix
+		void updateCollisionVectors(EntityId id) {
+			const glm::mat4& m = transform[id];
+			Ax[id] = glm::normalize(glm::vec3(m[0]));
+			Ay[id] = glm::normalize(glm::vec3(m[1]));
+			Az[id] = glm::normalize(glm::vec3(m[2]));
+			center[id] = glm::vec3(m[3]);
+		}
+		// remembers the current world matrices as the state of the tick about to be replaced
+		void snapshot() {
+			previousTransform = transform;
+		}
+		// world matrix of `id` blended `alpha` of the way from the previous tick to the current one
+		glm::mat4 interpolated(EntityId id, float alpha) const {
+			return previousTransform[id] + (transform[id] - previousTransform[id]) * alpha;
+		}
+		size_t count() const { return asset.size(); }
+
+		Column<ModelAsset*> asset;
+		Column<glm::vec3> position;
+		Column<float> yaw;
+		Column<glm::vec3> size;
+		Column<glm::mat4> transform;
+		Column<glm::mat4> previousTransform;
+		Column<glm::vec3> center;
+		Column<glm::vec3> Ax, Ay, Az;
+		Column<EntityId> parent;
+		Column<glm::mat4> local;	// rigid placement relative to the parent
+		Column<glm::mat4> pose;	// rigid world placement, `transform` without the scale
+		Column<unsigned char> poseFlags;
+
+	private:
+		enum {
+			POSE_DIRTY = 1,
+			POSE_TELEPORTED = 2
+		};
+	};
+
+}
+#endif
@@ -0,0 +1,115 @@
+#ifndef FIRINGSOLVER_H
+#define FIRINGSOLVER_H
+#include "Arena.h"
+#include "EntityStore.h"
+#include "Trig.h"
+#include <algorithm>
+#include <cmath>
+
+namespace cb {
+
+	/*
+	Firing solutions for many shooter/target pairs at once
+
+	Pair i is a muzzle pivot, a target point and the target's ground velocity. `solve` finds
+	the turret yaw and the low and high elevations that land a shell of the given speed on
+	where the target will be when the shell gets there, counting the height between the two.
+	The lead is refined a fixed number of times from the low arc's flight time. A pair out of
+	reach gets the elevation of its longest throw and is not `reachable`.
+
+	Pairs are stored a block of LANES at a time, one array per value, like ObbBatch does. The
+	loop over a block's lanes has no branches or calls, so it compiles to a few vector
+	instructions per value (GCC wants -fno-math-errno for the square roots and
+	-fno-trapping-math for the selects, MSVC /fp:fast).
+	*/
+	class FiringSolver {
+	public:
+		static const int LANES = 8;
+		static const int LEAD_ITERATIONS = 3;
+
+		struct Block {
+			// inputs
+			float fromX[LANES], fromY[LANES], fromZ[LANES];
+			float toX[LANES], toY[LANES], toZ[LANES];
+			float velocityX[LANES], velocityZ[LANES];
+			// outputs: turret yaw as Tank::rightOrientation counts it, elevations above the
+			// horizon in degrees, flight times in seconds, 1 or 0
+			float yaw[LANES];
+			float lowElevation[LANES], highElevation[LANES];
+			float lowFlight[LANES], highFlight[LANES];
+			float reachable[LANES];
+		};
+
+		FiringSolver(Arena* arena = NULL) : count(0), blocks(ArenaAllocator<Block>(arena)) {}
+		void reserve(size_t pairs) { blocks.reserve((pairs + LANES - 1) / LANES); }
+		// makes room for `pairs` pairs; set each of them with `aim` before solving
+		void resize(size_t pairs) {
+			count = pairs;
+			blocks.resize((pairs + LANES - 1) / LANES);
+		}
+		size_t size() const { return count; }
+		size_t blockCount() const { return blocks.size(); }
+
+		// pair `i` shoots from `pivot` at `target`, which drives at `velocity` per second
+		void aim(size_t i, glm::vec3 pivot, glm::vec3 target, glm::vec3 velocity) {
+			Block& b = blocks[i / LANES];
+			int lane = (int)(i % LANES);
+			b.fromX[lane] = pivot.x;
+			b.fromY[lane] = pivot.y;
+			b.fromZ[lane] = pivot.z;
+			b.toX[lane] = target.x;
+			b.toY[lane] = target.y;
+			b.toZ[lane] = target.z;
+			b.velocityX[lane] = velocity.x;
+			b.velocityZ[lane] = velocity.z;
+		}
+		// solves the pairs in blocks [begin, end); ranges of blocks that do not overlap can be
+		// solved in parallel
+		void solve(size_t begin, size_t end, float speed, float gravity) {
+			for (size_t k = begin; k < end; k++)
+				solveBlock(blocks[k], (int)std::min(count - k * LANES, (size_t)LANES), speed, gravity);
+		}
+
+		float yaw(size_t i) const { return blocks[i / LANES].yaw[i % LANES]; }
+		float lowElevation(size_t i) const { return blocks[i / LANES].lowElevation[i % LANES]; }
+		float highElevation(size_t i) const { return blocks[i / LANES].highElevation[i % LANES]; }
+		float lowFlight(size_t i) const { return blocks[i / LANES].lowFlight[i % LANES]; }
+		float highFlight(size_t i) const { return blocks[i / LANES].highFlight[i % LANES]; }
+		bool reachable(size_t i) const { return blocks[i / LANES].reachable[i % LANES] != 0; }
+
+	private:
+		static void solveBlock(Block& b, int lanes, float speed, float gravity) {
+			float v2 = speed * speed;
+			for (int i = 0; i < lanes; i++) {
+				float dx = b.toX[i] - b.fromX[i], dy = b.toY[i] - b.fromY[i], dz = b.toZ[i] - b.fromZ[i];
+				// first guess of the flight time: straight there
+				float t = std::sqrt(dx*dx + dy*dy + dz*dz) / speed;
+				float ax = dx, az = dz, x2 = 0, disc = 0, root = 0, gx = 0, lowTan = 0;
+				for (int k = 0; k < LEAD_ITERATIONS; k++) {
+					ax = dx + b.velocityX[i] * t;
+					az = dz + b.velocityZ[i] * t;
+					x2 = ax*ax + az*az;
+					// tan of the elevation is (v^2 -+ sqrt(disc)) / (g x) for the low and high arc
+					disc = v2*v2 - gravity * (gravity*x2 + 2 * dy*v2);
+					root = std::sqrt(std::max(disc, 0.0f));
+					gx = std::max(gravity * std::sqrt(x2), 1e-6f);
+					lowTan = (v2 - root) / gx;
+					// horizontal speed is v cos(elevation)
+					t = std::sqrt(x2 * (1 + lowTan*lowTan)) / speed;
+				}
+				float highTan = (v2 + root) / gx;
+				b.yaw[i] = atan2Deg(ax, -az);
+				b.lowElevation[i] = atan2Deg(lowTan, 1);
+				b.highElevation[i] = atan2Deg(highTan, 1);
+				b.lowFlight[i] = t;
+				b.highFlight[i] = std::sqrt(x2 * (1 + highTan*highTan)) / speed;
+				b.reachable[i] = (float)(disc >= 0);
+			}
+		}
+
+		size_t count;
+		Column<Block> blocks;
+	};
+
+}
+#endif
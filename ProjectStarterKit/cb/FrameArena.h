@@ -0,0 +1,121 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+#include "Arena.h"
+#include <stdexcept>
+#include <type_traits>
+
+namespace cb {
+
+	/*
+	Fixed-capacity list living in scratch memory
+
+	Holds plain data only: nothing is constructed or destroyed, the memory just goes away with
+	the frame it was taken from.
+	*/
+	template <typename T>
+	class ScratchList {
+	public:
+		ScratchList(T* memory, size_t capacity) : items(memory), count(0), cap(capacity) {}
+
+		void push_back(const T& item) {
+			if (count == cap)
+				throw std::runtime_error("ScratchList is full");
+			items[count++] = item;
+		}
+		void clear() { count = 0; }
+		T& operator[](size_t i) { return items[i]; }
+		const T& operator[](size_t i) const { return items[i]; }
+		T* begin() { return items; }
+		T* end() { return items + count; }
+		size_t size() const { return count; }
+		size_t capacity() const { return cap; }
+		bool empty() const { return count == 0; }
+		bool full() const { return count == cap; }
+
+	private:
+		T* items;
+		size_t count;
+		size_t cap;
+	};
+
+	/*
+	Scratch memory for one frame or one simulation tick
+
+	Contact lists, draw lists, uniform staging and query results are taken from here instead of
+	the heap. Taking memory is a pointer bump and nothing is ever freed on its own; `beginFrame`
+	drops everything taken during the last frame at once.
+	*/
+	class FrameArena {
+	public:
+		// `parent`, when given, provides the block instead of the global heap
+		explicit FrameArena(size_t bytes, Arena* parent = NULL) : arena(bytes, parent) {}
+
+		void beginFrame() { arena.reset(); }
+		// uninitialized room for `n` values of `T`, valid until the next `beginFrame`
+		template <typename T>
+		T* scratch(size_t n) {
+			static_assert(std::is_trivially_destructible<T>::value, "scratch memory is never destroyed");
+			return static_cast<T*>(arena.allocate(n * sizeof(T), alignof(T)));
+		}
+		template <typename T>
+		ScratchList<T> list(size_t capacity) {
+			return ScratchList<T>(scratch<T>(capacity), capacity);
+		}
+		// for containers that take an ArenaAllocator, and for ScratchScope
+		Arena* memory() { return &arena; }
+		size_t used() const { return arena.used(); }
+		size_t capacity() const { return arena.capacity(); }
+
+	private:
+		Arena arena;
+	};
+
+	/*
+	Gives back everything taken from a frame arena while the scope was open
+
+	For scratch that is dead once a call returns, so a function called many times per frame
+	reuses the same memory instead of piling up.
+	*/
+	class ScratchScope {
+	public:
+		explicit ScratchScope(FrameArena& frame) : arena(frame.memory()), mark(frame.used()) {}
+		~ScratchScope() { arena->rewind(mark); }
+
+	private:
+		Arena* arena;
+		size_t mark;
+
+		ScratchScope(const ScratchScope&);
+		const ScratchScope& operator=(const ScratchScope&);
+	};
+
+	/*
+	Two frame arenas used in turns
+
+	`beginFrame` swaps them and clears only the one it switches to, so what was taken last
+	frame stays valid for one more frame (last frame's draw list, results to compare against).
+	*/
+	class DoubleFrameArena {
+	public:
+		explicit DoubleFrameArena(size_t bytesPerFrame, Arena* parent = NULL) :
+			even(bytesPerFrame, parent),
+			odd(bytesPerFrame, parent),
+			current(0)
+		{}
+		void beginFrame() {
+			current ^= 1;
+			thisFrame().beginFrame();
+		}
+		FrameArena& thisFrame() { return current ? odd : even; }
+		FrameArena& lastFrame() { return current ? even : odd; }
+
+	private:
+		FrameArena even, odd;
+		int current;
+
+		DoubleFrameArena(const DoubleFrameArena&);
+		const DoubleFrameArena& operator=(const DoubleFrameArena&);
+	};
+
+}
+#endif
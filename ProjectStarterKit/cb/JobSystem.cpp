@@ -0,0 +1,140 @@
+#include "JobSystem.h"
+
+using namespace cb;
+
+JobSystem::JobSystem(unsigned threadCount) :
+	graph(NULL),
+	pendingCapacity(0),
+	remaining(0),
+	epoch(0),
+	stopping(false)
+{
+	workers = threadCount;
+	if (workers == 0)
+		workers = std::thread::hardware_concurrency();
+	if (workers == 0)
+		workers = 1;
+	queues.reset(new Queue[workers]);
+	for (unsigned i = 0; i < workers; i++) {
+		queues[i].head = 0;
+		queues[i].tail = 0;
+	}
+	for (unsigned i = 1; i < workers; i++)
+		threads.push_back(std::thread(&JobSystem::serve, this, i));
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+void JobSystem::run(TaskGraph& tasks) {
+	size_t count = tasks.size();
+	if (count == 0)
+		return;
+	if (pendingCapacity < count) {
+		pending.reset(new std::atomic<unsigned int>[count]);
+		pendingCapacity = count;
+	}
+	for (size_t i = 0; i < count; i++)
+		pending[i].store(tasks.tasks[i].dependencies, std::memory_order_relaxed);
+	failure = std::exception_ptr();
+	graph = &tasks;
+	remaining.store(count, std::memory_order_release);
+	for (size_t i = 0; i < count; i++) {
+		if (tasks.tasks[i].dependencies == 0)
+			push(0, (unsigned int)i);
+	}
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		epoch++;
+	}
+	wake.notify_all();
+
+	work(0);
+	graph = NULL;
+	if (failure)
+		std::rethrow_exception(failure);
+}
+
+// body of every worker thread but the caller's: sleeps until a graph starts, then helps with it
+void JobSystem::serve(unsigned self) {
+	unsigned long long seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> guard(sleepLock);
+			wake.wait(guard, [&] { return stopping || epoch != seen; });
+			if (stopping)
+				return;
+			seen = epoch;
+		}
+		work(self);
+	}
+}
+
+void JobSystem::work(unsigned self) {
+	while (remaining.load(std::memory_order_acquire) > 0) {
+		unsigned int task;
+		if (pop(self, task) || steal(self, task))
+			execute(self, task);
+		else
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::push(unsigned self, unsigned int task) {
+	Queue& q = queues[self];
+	{
+		std::lock_guard<std::mutex> guard(q.lock);
+		if (q.tail - q.head < QUEUE_SIZE) {
+			q.items[q.tail++ % QUEUE_SIZE] = task;
+			return;
+		}
+	}
+	// a full deque just means plenty of work is queued; run this one right away
+	execute(self, task);
+}
+
+bool JobSystem::pop(unsigned self, unsigned int& task) {
+	Queue& q = queues[self];
+	std::lock_guard<std::mutex> guard(q.lock);
+	if (q.tail == q.head)
+		return false;
+	task = q.items[--q.tail % QUEUE_SIZE];
+	return true;
+}
+
+bool JobSystem::steal(unsigned self, unsigned int& task) {
+	for (unsigned i = 1; i < workers; i++) {
+		Queue& q = queues[(self + i) % workers];
+		std::lock_guard<std::mutex> guard(q.lock);
+		if (q.tail != q.head) {
+			task = q.items[q.head++ % QUEUE_SIZE];
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::execute(unsigned self, unsigned int task) {
+	const TaskGraph::Task& t = graph->tasks[task];
+	try {
+		t.function(t.context, t.begin, t.end);
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> guard(failureLock);
+		if (!failure)
+			failure = std::current_exception();
+	}
+	for (unsigned int e = t.firstEdge; e != TaskGraph::NONE; e = graph->edges[e].next) {
+		unsigned int next = graph->edges[e].to;
+		if (pending[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			push(self, next);
+	}
+	remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
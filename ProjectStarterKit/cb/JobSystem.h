@@ -0,0 +1,176 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace cb {
+
+	/*
+	Tasks of one parallel step and the order they have to run in
+
+	A task is a plain function pointer and context over an index range, so building a graph
+	does not allocate once its arrays are warm; keep one graph around and `clear` it each tick.
+	Dependencies only ever point forward (a task can only wait on tasks added before it), so
+	running the tasks in the order they were added is always a valid serial schedule.
+	*/
+	class TaskGraph {
+	public:
+		typedef void (*Function)(void* context, size_t begin, size_t end);
+		static const unsigned int NONE = 0xFFFFFFFF;
+
+		void reserve(size_t taskCount, size_t edgeCount) {
+			tasks.reserve(taskCount);
+			edges.reserve(edgeCount);
+		}
+		void clear() {
+			tasks.clear();
+			edges.clear();
+		}
+		// adds `function(context, begin, end)`; returns its task
+		unsigned int add(Function function, void* context, size_t begin = 0, size_t end = 0) {
+			Task task = { function, context, begin, end, 0, NONE };
+			tasks.push_back(task);
+			return (unsigned int)(tasks.size() - 1);
+		}
+		// adds `fn(begin, end)`; `fn` has to outlive the run of the graph
+		template <typename F>
+		unsigned int add(F& fn, size_t begin = 0, size_t end = 0) {
+			return add(&invoke<F>, &fn, begin, end);
+		}
+		/*
+		Splits [0, count) into ranges of at most `grain` items, one task each, all waiting on
+		`after` if given. Returns a task that runs once every range is done.
+		*/
+		template <typename F>
+		unsigned int addRange(F& fn, size_t count, size_t grain, unsigned int after = NONE) {
+			if (grain == 0)
+				grain = 1;
+			for (size_t begin = 0; begin < count; begin += grain) {
+				unsigned int range = add(fn, begin, std::min(begin + grain, count));
+				if (after != NONE)
+					precede(after, range);
+			}
+			unsigned int first = (unsigned int)tasks.size() - (unsigned int)((count + grain - 1) / grain);
+			unsigned int join = add(&nothing, NULL);
+			if (after != NONE)
+				precede(after, join);
+			for (unsigned int range = first; range < join; range++)
+				precede(range, join);
+			return join;
+		}
+		// `after` does not start before `before` finished
+		void precede(unsigned int before, unsigned int after) {
+			if (before >= after || after >= tasks.size())
+				throw std::runtime_error("TaskGraph dependencies have to point to later tasks");
+			Edge edge = { after, tasks[before].firstEdge };
+			edges.push_back(edge);
+			tasks[before].firstEdge = (unsigned int)(edges.size() - 1);
+			tasks[after].dependencies++;
+		}
+		// runs every task on the calling thread, in the order they were added
+		void runInline() {
+			for (size_t i = 0; i < tasks.size(); i++)
+				tasks[i].function(tasks[i].context, tasks[i].begin, tasks[i].end);
+		}
+		size_t size() const { return tasks.size(); }
+
+	private:
+		friend class JobSystem;
+
+		struct Task {
+			Function function;
+			void* context;
+			size_t begin, end;
+			unsigned int dependencies;
+			unsigned int firstEdge;
+		};
+		struct Edge {
+			unsigned int to;
+			unsigned int next;
+		};
+
+		template <typename F>
+		static void invoke(void* context, size_t begin, size_t end) {
+			(*static_cast<F*>(context))(begin, end);
+		}
+		static void nothing(void*, size_t, size_t) {}
+
+		std::vector<Task> tasks;
+		std::vector<Edge> edges;
+	};
+
+	/*
+	Work-stealing scheduler
+
+	Every worker owns a deque of ready tasks. It pushes and pops its own end, so the tasks a
+	finished task unlocks run next on the same core while their data is still in its cache;
+	a worker that runs dry steals from the other end of someone else's deque. The thread that
+	calls `run` works as worker 0 until the graph is done, and the other workers sleep between
+	graphs. Only one graph runs at a time.
+	*/
+	class JobSystem {
+	public:
+		// `threadCount` of 0 means one per hardware thread, counting the caller of `run`
+		explicit JobSystem(unsigned threadCount = 0);
+		~JobSystem();
+
+		// runs every task of `graph` in dependency order; rethrows the first exception a task threw
+		void run(TaskGraph& graph);
+		unsigned workerCount() const { return workers; }
+
+	private:
+		static const unsigned int QUEUE_SIZE = 4096;
+
+		// one worker's tasks; padded so neighbouring workers do not share a cache line
+		struct Queue {
+			std::mutex lock;
+			unsigned int head, tail;
+			unsigned int items[QUEUE_SIZE];
+			char padding[64];
+		};
+
+		void serve(unsigned self);
+		void work(unsigned self);
+		void push(unsigned self, unsigned int task);
+		bool pop(unsigned self, unsigned int& task);
+		bool steal(unsigned self, unsigned int& task);
+		void execute(unsigned self, unsigned int task);
+
+		unsigned workers;
+		std::unique_ptr<Queue[]> queues;
+		std::vector<std::thread> threads;
+
+		TaskGraph* graph;
+		std::unique_ptr<std::atomic<unsigned int>[]> pending;
+		size_t pendingCapacity;
+		std::atomic<size_t> remaining;
+		std::exception_ptr failure;
+		std::mutex failureLock;
+
+		std::mutex sleepLock;
+		std::condition_variable wake;
+		unsigned long long epoch;
+		bool stopping;
+
+		JobSystem(const JobSystem&);
+		const JobSystem& operator=(const JobSystem&);
+	};
+
+	// runs `graph` on `jobs`, or inline on this thread when there is no job system
+	inline void runGraph(JobSystem* jobs, TaskGraph& graph) {
+		if (jobs)
+			jobs->run(graph);
+		else
+			graph.runInline();
+	}
+
+}
+#endif
@@ -0,0 +1,87 @@
+#include "MatchHost.h"
+#include "World.h"
+#include <atomic>
+#include <exception>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+using namespace cb;
+
+// keeps the calling thread on one core so its world's arena stays in that core's caches
+static void PinToCore(unsigned core) {
+#ifdef _WIN32
+	SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (core % (sizeof(DWORD_PTR) * 8)));
+#else
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(core % CPU_SETSIZE, &cpus);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#endif
+}
+
+/*
+Takes matches off `next` until none are left, each in a fresh world placed in this worker's arena.
+The worker pins itself to `core` before it allocates the arena, so the arena is first touched,
+and placed, on that core.
+*/
+static void Work(unsigned core, std::atomic<unsigned>* next, unsigned matches, unsigned long long maxTicks, size_t arenaBytes, std::vector<MatchResult>* results, std::exception_ptr* error) {
+	PinToCore(core);
+	try {
+		Arena arena(arenaBytes);
+		TankControls idle;
+		for (unsigned match = (*next)++; match < matches; match = (*next)++) {
+			arena.reset();
+			World* world = new (arena.allocate(sizeof(World), alignof(World))) World(&arena);
+			world->CreateInstances(MatchAssets());
+
+			unsigned long long ticks = 0;
+			while (!world->terminated && ticks < maxTicks) {
+				world->SimulationTick((float)TICK_SECONDS, idle, true);
+				ticks++;
+			}
+
+			MatchResult& result = (*results)[match];
+			result.ticks = ticks;
+			result.playerHealth = world->GetPlayer().getHealth();
+			result.score = world->score;
+			world->~World();
+		}
+	}
+	catch (...) {
+		*error = std::current_exception();
+	}
+}
+
+MatchHost::MatchHost(unsigned workerThreads, size_t arenaBytesPerWorld) {
+	workers = workerThreads;
+	if (workers == 0)
+		workers = std::thread::hardware_concurrency();
+	if (workers == 0)
+		workers = 1;
+	arenaBytes = arenaBytesPerWorld;
+}
+
+std::vector<MatchResult> MatchHost::run(unsigned matches, unsigned long long maxTicks) {
+	std::vector<MatchResult> results(matches);
+	std::atomic<unsigned> next(0);
+	std::vector<std::thread> threads;
+	std::vector<std::exception_ptr> errors(workers);
+	for (unsigned i = 0; i < workers && i < matches; i++) {
+		threads.push_back(std::thread(Work, i, &next, matches, maxTicks, arenaBytes, &results, &errors[i]));
+	}
+	for (size_t i = 0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+	// a worker that failed reports to the caller the same way a single-threaded run would
+	for (size_t i = 0; i < errors.size(); i++) {
+		if (errors[i])
+			std::rethrow_exception(errors[i]);
+	}
+	return results;
+}
@@ -0,0 +1,40 @@
+#ifndef MATCHHOST_H
+#define MATCHHOST_H
+#include <cstddef>
+#include <vector>
+
+namespace cb {
+
+	/*
+	Outcome of one hosted match
+	*/
+	struct MatchResult {
+		unsigned long long ticks;
+		double playerHealth;
+		double score;
+	};
+
+	/*
+	Runs many independent matches in parallel
+
+	Starts one worker thread per core, pins each to its core, and lets the workers pull matches
+	off a shared counter until all are done. Every worker owns one arena; each match it runs
+	gets the whole arena to itself and the arena is reset between matches, so worlds never
+	share memory or touch the global heap for their pools.
+	*/
+	class MatchHost {
+	public:
+		// `workers` of 0 means one per hardware thread
+		MatchHost(unsigned workers, size_t arenaBytesPerWorld);
+
+		// plays `matches` AI matches of at most `maxTicks` ticks each and returns their results
+		std::vector<MatchResult> run(unsigned matches, unsigned long long maxTicks);
+		unsigned workerCount() const { return workers; }
+
+	private:
+		unsigned workers;
+		size_t arenaBytes;
+	};
+
+}
+#endif
@@ -0,0 +1,200 @@
+#ifndef NAVGRID_H
+#define NAVGRID_H
+#include "Arena.h"
+#include "EntityStore.h"
+#include <algorithm>
+#include <cmath>
+
+namespace cb {
+
+	/*
+	Square grid over the XZ plane that marks where a tank can not drive
+
+	Static obstacles are rasterized into it once, grown by the clearance a tank body needs.
+	Every change bumps `version`, so flow fields built from an older grid know to rebuild.
+	*/
+	class NavGrid {
+	public:
+		// `cells` by `cells` cells of `cellSize`, centered on the origin
+		NavGrid(float cellSize, int cells, Arena* arena = NULL) :
+			version(0),
+			cell(cellSize),
+			side(cells),
+			origin(-cellSize * cells / 2),
+			blocked(cells * cells, 0, ArenaAllocator<unsigned char>(arena))
+		{}
+		// marks every cell whose center lies in the XZ rectangle [lo, hi]
+		void block(glm::vec2 lo, glm::vec2 hi) {
+			int minX = std::max(0, (int)std::ceil((lo.x - origin) / cell - 0.5f));
+			int minZ = std::max(0, (int)std::ceil((lo.y - origin) / cell - 0.5f));
+			int maxX = std::min(side - 1, (int)std::floor((hi.x - origin) / cell - 0.5f));
+			int maxZ = std::min(side - 1, (int)std::floor((hi.y - origin) / cell - 0.5f));
+			for (int z = minZ; z <= maxZ; z++) {
+				for (int x = minX; x <= maxX; x++)
+					blocked[z * side + x] = 1;
+			}
+			version++;
+		}
+		// cell under `p`, or -1 when it is off the grid
+		int cellAt(glm::vec2 p) const {
+			int x = (int)std::floor((p.x - origin) / cell);
+			int z = (int)std::floor((p.y - origin) / cell);
+			if (x < 0 || z < 0 || x >= side || z >= side)
+				return -1;
+			return z * side + x;
+		}
+		// the cell under `p`, or the nearest one when `p` is off the grid
+		int nearestCell(glm::vec2 p) const {
+			int x = std::min(side - 1, std::max(0, (int)std::floor((p.x - origin) / cell)));
+			int z = std::min(side - 1, std::max(0, (int)std::floor((p.y - origin) / cell)));
+			return z * side + x;
+		}
+		glm::vec2 center(int c) const {
+			return glm::vec2(origin + (c % side + 0.5f) * cell, origin + (c / side + 0.5f) * cell);
+		}
+		bool isBlocked(int c) const { return blocked[c] != 0; }
+		int width() const { return side; }
+		size_t cellCount() const { return blocked.size(); }
+
+		unsigned int version;
+
+	private:
+		float cell;
+		int side;
+		float origin;
+		Column<unsigned char> blocked;
+	};
+
+	/*
+	Steps to a goal cell from every cell of a nav grid, shared by every tank that heads there
+
+	Built breadth-first over the eight neighbours of each cell, never cutting the corner of a
+	blocked cell. A tank reads one cell and its neighbours to know where to drive, however many
+	tanks follow the same field.
+
+	The field is double-buffered: `advance` grows the next field a bounded number of cells at a
+	time while tanks keep reading the finished one, and `swap` publishes it once it is done. So
+	when the goal moves to another cell the field follows within a few ticks, at a flat cost per
+	tick. `advance` only touches the field being built, so it can run alongside readers.
+	*/
+	class FlowField {
+	public:
+		static const unsigned short UNREACHED = 0xFFFF;
+
+		FlowField(const NavGrid& grid, Arena* arena = NULL) :
+			nav(&grid),
+			goal(-1),
+			building(-1),
+			builtVersion(0),
+			buildVersion(0),
+			head(0),
+			tail(0),
+			steps(grid.cellCount(), +UNREACHED, ArenaAllocator<unsigned short>(arena)),
+			next(grid.cellCount(), +UNREACHED, ArenaAllocator<unsigned short>(arena)),
+			queue(grid.cellCount(), 0, ArenaAllocator<unsigned int>(arena))
+		{}
+		// starts building towards `cell` unless a build is under way or the field already leads there
+		void retarget(int cell) {
+			if (building >= 0 || (cell == goal && builtVersion == nav->version))
+				return;
+			std::fill(next.begin(), next.end(), +UNREACHED);
+			building = cell;
+			buildVersion = nav->version;
+			next[cell] = 0;
+			queue[0] = (unsigned int)cell;
+			head = 0;
+			tail = 1;
+		}
+		// expands up to `budget` cells of the field being built; true when it is complete
+		bool advance(size_t budget) {
+			if (building < 0)
+				return false;
+			int side = nav->width();
+			for (; budget > 0 && head < tail; budget--) {
+				int c = (int)queue[head++];
+				int x = c % side, z = c / side;
+				unsigned short d = next[c] + 1;
+				for (int dz = -1; dz <= 1; dz++) {
+					for (int dx = -1; dx <= 1; dx++) {
+						int nx = x + dx, nz = z + dz;
+						if ((dx == 0 && dz == 0) || nx < 0 || nz < 0 || nx >= side || nz >= side)
+							continue;
+						int n = nz * side + nx;
+						if (next[n] != UNREACHED || nav->isBlocked(n))
+							continue;
+						if (dx != 0 && dz != 0 && (nav->isBlocked(z * side + nx) || nav->isBlocked(nz * side + x)))
+							continue;
+						next[n] = d;
+						queue[tail++] = (unsigned int)n;
+					}
+				}
+			}
+			return head == tail;
+		}
+		// publishes the field being built once `advance` finished it
+		void swap() {
+			if (building < 0 || head != tail)
+				return;
+			steps.swap(next);
+			goal = building;
+			builtVersion = buildVersion;
+			building = -1;
+		}
+		// builds towards `cell` right away
+		void rebuild(int cell) {
+			building = -1;
+			goal = -1;
+			retarget(cell);
+			advance(nav->cellCount());
+			swap();
+		}
+		bool ready() const { return goal >= 0; }
+		int target() const { return goal; }
+		/*
+		Where to drive from cell `c`: towards the neighbour nearest the goal, picking among equally
+		near ones the one most in line with the goal. False on the goal cell, off the field, and
+		where the goal can not be reached; the caller heads straight for the goal then.
+		*/
+		bool direction(int c, glm::vec2& dir) const {
+			if (goal < 0 || c < 0 || c == goal || steps[c] == UNREACHED)
+				return false;
+			int side = nav->width();
+			int x = c % side, z = c / side;
+			glm::vec2 toGoal(goal % side - x, goal / side - z);
+			unsigned short best = steps[c];
+			float bestAlign = -2;
+			for (int dz = -1; dz <= 1; dz++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					int nx = x + dx, nz = z + dz;
+					if ((dx == 0 && dz == 0) || nx < 0 || nz < 0 || nx >= side || nz >= side)
+						continue;
+					int n = nz * side + nx;
+					if (steps[n] >= steps[c] || steps[n] > best)
+						continue;
+					if (dx != 0 && dz != 0 && (nav->isBlocked(z * side + nx) || nav->isBlocked(nz * side + x)))
+						continue;
+					glm::vec2 step(dx, dz);
+					float align = glm::dot(step, toGoal) / (glm::length(step) * glm::length(toGoal));
+					if (steps[n] < best || align > bestAlign) {
+						best = steps[n];
+						bestAlign = align;
+						dir = step;
+					}
+				}
+			}
+			return bestAlign > -2;
+		}
+
+	private:
+		const NavGrid* nav;
+		int goal;			// cell `steps` leads to, or -1 before the first build
+		int building;		// cell `next` is being built towards, or -1
+		unsigned int builtVersion, buildVersion;
+		size_t head, tail;
+		Column<unsigned short> steps;	// steps from each cell to `goal`
+		Column<unsigned short> next;	// the same for `building`, while it is built
+		Column<unsigned int> queue;		// breadth-first frontier of the build
+	};
+
+}
+#endif
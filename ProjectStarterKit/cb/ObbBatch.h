@@ -0,0 +1,301 @@
+#ifndef OBBBATCH_H
+#define OBBBATCH_H
+#include "EntityStore.h"
+#include <cmath>
+
+// lane width of the batched box test: AVX when the compiler targets it, else SSE, else scalar
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CB_OBB_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define CB_OBB_SSE
+#endif
+
+namespace cb {
+
+	/*
+	One oriented box packed for collision: center, orthonormal axes and half-extents along them
+	*/
+	struct Obb {
+		glm::vec3 center;
+		glm::vec3 axis[3];
+		glm::vec3 half;
+	};
+
+	inline Obb packObb(const EntityStore& store, EntityId id) {
+		Obb box;
+		box.center = store.center[id];
+		box.axis[0] = store.Ax[id];
+		box.axis[1] = store.Ay[id];
+		box.axis[2] = store.Az[id];
+		box.half = store.size[id];
+		return box;
+	}
+
+	// true for boxes that are only yawed: their second axis is world up (or down)
+	inline bool isUpright(const Obb& box) {
+		return std::fabs(box.axis[1].y) > 1 - 1e-5f;
+	}
+
+	namespace lanes {
+#if defined(CB_OBB_AVX)
+		const int WIDTH = 8;
+		typedef __m256 f;
+		inline f load(const float* p) { return _mm256_loadu_ps(p); }
+		inline f set(float v) { return _mm256_set1_ps(v); }
+		inline f add(f a, f b) { return _mm256_add_ps(a, b); }
+		inline f sub(f a, f b) { return _mm256_sub_ps(a, b); }
+		inline f mul(f a, f b) { return _mm256_mul_ps(a, b); }
+		inline f abs(f a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+		inline unsigned int greater(f a, f b) { return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+#elif defined(CB_OBB_SSE)
+		const int WIDTH = 4;
+		typedef __m128 f;
+		inline f load(const float* p) { return _mm_loadu_ps(p); }
+		inline f set(float v) { return _mm_set1_ps(v); }
+		inline f add(f a, f b) { return _mm_add_ps(a, b); }
+		inline f sub(f a, f b) { return _mm_sub_ps(a, b); }
+		inline f mul(f a, f b) { return _mm_mul_ps(a, b); }
+		inline f abs(f a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+		inline unsigned int greater(f a, f b) { return (unsigned int)_mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+#else
+		const int WIDTH = 1;
+		typedef float f;
+		inline f load(const float* p) { return *p; }
+		inline f set(float v) { return v; }
+		inline f add(f a, f b) { return a + b; }
+		inline f sub(f a, f b) { return a - b; }
+		inline f mul(f a, f b) { return a * b; }
+		inline f abs(f a) { return std::fabs(a); }
+		inline unsigned int greater(f a, f b) { return a > b ? 1u : 0u; }
+#endif
+	}
+
+	/*
+	Up to `lanes::WIDTH` boxes laid out one float per lane, so a single box can be tested against
+	all of them at once
+	*/
+	struct ObbBatch {
+		static const int WIDTH = lanes::WIDTH;
+
+		float center[3][WIDTH];
+		float axis[3][3][WIDTH];	// axis[k][component][lane]
+		float half[3][WIDTH];
+		int count;
+		bool upright;	// every box in the batch is only yawed
+
+		ObbBatch() : count(0), upright(true) {}
+		bool full() const { return count == WIDTH; }
+		void clear() {
+			count = 0;
+			upright = true;
+		}
+		void add(const Obb& box) {
+			upright = upright && isUpright(box);
+			for (int c = 0; c < 3; c++) {
+				center[c][count] = box.center[c];
+				half[c][count] = box.half[c];
+				for (int k = 0; k < 3; k++)
+					axis[k][c][count] = box.axis[k][c];
+			}
+			count++;
+		}
+	};
+
+	// marks the lanes in `mask` separated by `axis`; true once every lane is separated
+	inline bool separate(unsigned int& separated, unsigned int mask, unsigned int all, unsigned char* axes, int axis) {
+		unsigned int fresh = mask & ~separated;
+		if (axes) {
+			for (int lane = 0; fresh; lane++, fresh >>= 1) {
+				if (fresh & 1)
+					axes[lane] = (unsigned char)axis;
+			}
+		}
+		separated |= mask;
+		return separated == all;
+	}
+
+	/*
+	Separating-axis test of `a` against every box in `batch`
+
+	Returns a mask with bit i set when `a` overlaps box i. Axes are evaluated in the frame of `a`;
+	lanes drop out as soon as an axis separates them, and the test stops once every lane has been
+	separated.
+
+	`Upright` selects the kernel at compile time. The general one runs all 15 axes, with a small
+	epsilon on the rotation terms so near-parallel edge pairs do not report a false separation.
+	When every box is only yawed, the edge cross products are either world up or lie in XZ along
+	a face normal, so the test reduces to the 4 face normals in XZ plus the Y interval.
+
+	When `axes` is given, axes[i] receives the id (see `separatedOn`) of the axis that separated
+	lane i, so callers can remember it for the next tick.
+	*/
+	template <bool Upright>
+	inline unsigned int overlapMaskOf(const Obb& a, const ObbBatch& batch, unsigned char* axes) {
+		using namespace lanes;
+		if (batch.count == 0)
+			return 0;
+		const unsigned int all = (1u << WIDTH) - 1;
+		const unsigned int active = (1u << batch.count) - 1;
+		unsigned int separated = all & ~active;
+
+		f T[3], ha[3], hb[3];
+		for (int c = 0; c < 3; c++) {
+			T[c] = sub(load(batch.center[c]), set(a.center[c]));
+			ha[c] = set(a.half[c]);
+			hb[c] = load(batch.half[c]);
+		}
+
+		if (Upright) {
+			// Y interval
+			if (separate(separated, greater(abs(T[1]), add(ha[1], hb[1])), all, axes, 1))
+				return 0;
+			// only the XZ parts of axes 0 and 2 matter; every other rotation term is 0 or 1
+			f Ta[3], R[3][3], AbsR[3][3];
+			for (int i = 0; i < 3; i += 2) {
+				Ta[i] = add(mul(T[0], set(a.axis[i].x)), mul(T[2], set(a.axis[i].z)));
+				for (int j = 0; j < 3; j += 2) {
+					R[i][j] = add(mul(load(batch.axis[j][0]), set(a.axis[i].x)), mul(load(batch.axis[j][2]), set(a.axis[i].z)));
+					AbsR[i][j] = abs(R[i][j]);
+				}
+			}
+			for (int i = 0; i < 3; i += 2) {
+				f rb = add(mul(hb[0], AbsR[i][0]), mul(hb[2], AbsR[i][2]));
+				if (separate(separated, greater(abs(Ta[i]), add(ha[i], rb)), all, axes, i))
+					return 0;
+			}
+			for (int j = 0; j < 3; j += 2) {
+				f t = add(mul(Ta[0], R[0][j]), mul(Ta[2], R[2][j]));
+				f ra = add(mul(ha[0], AbsR[0][j]), mul(ha[2], AbsR[2][j]));
+				if (separate(separated, greater(abs(t), add(ra, hb[j])), all, axes, 3 + j))
+					return 0;
+			}
+			return active & ~separated;
+		}
+
+		// offset between centers, expressed in a's frame
+		f Ta[3];
+		for (int i = 0; i < 3; i++)
+			Ta[i] = add(add(mul(T[0], set(a.axis[i].x)), mul(T[1], set(a.axis[i].y))), mul(T[2], set(a.axis[i].z)));
+
+		// R[i][j] = a.axis[i] . b.axis[j]
+		f R[3][3], AbsR[3][3];
+		const f epsilon = set(1e-6f);
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				R[i][j] = add(add(mul(load(batch.axis[j][0]), set(a.axis[i].x)), mul(load(batch.axis[j][1]), set(a.axis[i].y))), mul(load(batch.axis[j][2]), set(a.axis[i].z)));
+				AbsR[i][j] = add(abs(R[i][j]), epsilon);
+			}
+		}
+
+		// a's face normals
+		for (int i = 0; i < 3; i++) {
+			f rb = add(add(mul(hb[0], AbsR[i][0]), mul(hb[1], AbsR[i][1])), mul(hb[2], AbsR[i][2]));
+			if (separate(separated, greater(abs(Ta[i]), add(ha[i], rb)), all, axes, i))
+				return 0;
+		}
+		// b's face normals
+		for (int j = 0; j < 3; j++) {
+			f t = add(add(mul(Ta[0], R[0][j]), mul(Ta[1], R[1][j])), mul(Ta[2], R[2][j]));
+			f ra = add(add(mul(ha[0], AbsR[0][j]), mul(ha[1], AbsR[1][j])), mul(ha[2], AbsR[2][j]));
+			if (separate(separated, greater(abs(t), add(ra, hb[j])), all, axes, 3 + j))
+				return 0;
+		}
+		// edge cross products a.axis[i] x b.axis[j]
+		for (int i = 0; i < 3; i++) {
+			int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+			for (int j = 0; j < 3; j++) {
+				int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+				f t = sub(mul(Ta[i2], R[i1][j]), mul(Ta[i1], R[i2][j]));
+				f ra = add(mul(ha[i1], AbsR[i2][j]), mul(ha[i2], AbsR[i1][j]));
+				f rb = add(mul(hb[j1], AbsR[i][j2]), mul(hb[j2], AbsR[i][j1]));
+				if (separate(separated, greater(abs(t), add(ra, rb)), all, axes, 6 + 3 * i + j))
+					return 0;
+			}
+		}
+		return active & ~separated;
+	}
+
+	// picks the yaw-only kernel when both sides allow it, the full 3D one for tilted bodies
+	inline unsigned int overlapMask(const Obb& a, const ObbBatch& batch, unsigned char* axes = NULL) {
+		if (batch.upright && isUpright(a))
+			return overlapMaskOf<true>(a, batch, axes);
+		return overlapMaskOf<false>(a, batch, axes);
+	}
+
+	/*
+	Candidate separating axis `axis` of the pair, not normalized
+
+	Axis ids: 0..2 are a's face normals, 3..5 b's face normals and 6 + 3i + j the cross product
+	of a's axis i with b's axis j.
+	*/
+	inline glm::vec3 axisOf(const Obb& a, const Obb& b, int axis) {
+		if (axis < 3)
+			return a.axis[axis];
+		if (axis < 6)
+			return b.axis[axis - 3];
+		return glm::cross(a.axis[(axis - 6) / 3], b.axis[(axis - 6) % 3]);
+	}
+
+	// half of the shadow `box` casts on `L`, in units of |L|
+	inline float projectedRadius(const Obb& box, const glm::vec3& L) {
+		return box.half.x * std::fabs(glm::dot(box.axis[0], L)) + box.half.y * std::fabs(glm::dot(box.axis[1], L)) + box.half.z * std::fabs(glm::dot(box.axis[2], L));
+	}
+
+	// single-axis test used to replay a cached separating axis
+	inline bool separatedOn(const Obb& a, const Obb& b, int axis) {
+		glm::vec3 L = axisOf(a, b, axis);
+		return std::fabs(glm::dot(b.center - a.center, L)) > projectedRadius(a, L) + projectedRadius(b, L);
+	}
+
+	/*
+	How far `a` has to move along `normal` to stop overlapping `b`
+	*/
+	struct Contact {
+		glm::vec3 normal;	// unit length, pointing from b towards a
+		float depth;
+	};
+
+	/*
+	Minimum-overlap axis of two overlapping boxes
+
+	Returns false when some axis separates them. With `planar` set only axes lying close to the
+	ground plane are considered for the contact (all 15 are still used to rule out overlap), so
+	ground vehicles are never pushed up or down.
+	*/
+	inline bool penetration(const Obb& a, const Obb& b, Contact& contact, bool planar) {
+		glm::vec3 d = a.center - b.center;
+		bool found = false;
+		contact.depth = 0;
+		for (int axis = 0; axis < 15; axis++) {
+			glm::vec3 L = axisOf(a, b, axis);
+			float length = glm::length(L);
+			// parallel edges give no axis
+			if (length < 1e-5f)
+				continue;
+			L /= length;
+			float along = glm::dot(d, L);
+			float overlap = projectedRadius(a, L) + projectedRadius(b, L) - std::fabs(along);
+			if (overlap <= 0)
+				return false;
+			if (planar && std::fabs(L.y) > 0.5f)
+				continue;
+			if (!found || overlap < contact.depth) {
+				found = true;
+				contact.depth = overlap;
+				contact.normal = along < 0 ? -L : L;
+			}
+		}
+		return found;
+	}
+
+	// conservative bound: bounding spheres of the two boxes do not touch
+	inline bool clearlyApart(const Obb& a, const Obb& b) {
+		glm::vec3 d = b.center - a.center;
+		float reach = glm::length(a.half) + glm::length(b.half);
+		return glm::dot(d, d) > reach * reach;
+	}
+
+}
+#endif
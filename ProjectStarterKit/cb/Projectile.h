@@ -1,6 +1,8 @@
 #ifndef PROJECTILE_H
 #define PROJECTILE_H
-#include "Structures.h"
+#include "Transform.h"
+#include "Ballistics.h"
+#include "Trig.h"
 namespace cb {
 	class Projectile {
 	public:
@@ -9,14 +11,14 @@ namespace cb {
 			y = 0;
 			z = 0;
 			xzAngle = 0;
-			body = nullptr;
 			yAngle = 0;
 			timeEllapsed = 0;
 			currentX = x;
 			currentY = y;
 			currentZ = z;
+			direction = glm::vec3(0, 0, -1);
 		}
-		Projectile(GLfloat xPos, GLfloat yPos, GLfloat zPos, ModelAsset & bodyAsset, GLfloat xzA, GLfloat yA) {
+		Projectile(float xPos, float yPos, float zPos, float xzA, float yA) {
 			x = xPos;
 			y = yPos;
 			z = zPos;
@@ -25,34 +27,34 @@ namespace cb {
 			currentZ = z;
 			xzAngle = xzA;
 			yAngle = yA;
-			body = new ModelInstance();
-			body->asset = &bodyAsset;
-			body->transform = translate(x, y, z)*scale(0.1f, 0.1f, 0.1f);
-			body->positionX = x;
-			body->positionY = y;
-			body->positionZ = z;
 			timeEllapsed = 0;
+			// the launch direction is fixed, so its trig is paid once per shell
+			float upSin, upCos, xzSin, xzCos;
+			sincosDeg(-yAngle, upSin, upCos);
+			sincosDeg(xzAngle, xzSin, xzCos);
+			direction = glm::vec3(upCos*xzSin, upSin, -upCos*xzCos);
 		}
-		ModelInstance*  getBody(){ return body;}
 		void move(float t,float g,float v) {
 			timeEllapsed += t;
-			currentX = x + glm::cos(glm::radians(-yAngle))*glm::sin(glm::radians(xzAngle))*v*timeEllapsed;
-			currentY = y + v*timeEllapsed*glm::sin(glm::radians(-yAngle)) - 0.5f*timeEllapsed*timeEllapsed*g;
-			currentZ = z - glm::cos(glm::radians(-yAngle))*glm::cos(glm::radians(xzAngle))*v*timeEllapsed;
-			body->transform=translate(currentX,currentY,currentZ)*scale(0.1f,0.1f,0.1f);
-		
+			currentX = x + direction.x*v*timeEllapsed;
+			currentY = y + v*timeEllapsed*direction.y - 0.5f*timeEllapsed*timeEllapsed*g;
+			currentZ = z + direction.z*v*timeEllapsed;
+		}
+		float getX() { return currentX; }
+		float getY() { return currentY; }
+		float getZ() { return currentZ; }
+		// the whole flight in closed form, for solving impacts ahead of time
+		Trajectory trajectory(float g, float v) const {
+			return Trajectory(glm::vec3(x, y, z), direction * v, g);
 		}
-		GLfloat getX() { return currentX; }
-		GLfloat getY() { return currentY; }
-		GLfloat getZ() { return currentZ; }
 	private:
-		ModelInstance* body;
-		GLfloat x, y, z,currentX,currentY,currentZ;
-		GLfloat xzAngle = 0;
-		GLfloat yAngle = 0;
-		GLfloat timeEllapsed = 0;
+		float x, y, z,currentX,currentY,currentZ;
+		glm::vec3 direction;
+		float xzAngle = 0;
+		float yAngle = 0;
+		float timeEllapsed = 0;
 	};
 
 
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,85 @@
+#ifndef PROJECTILEPOOL_H
+#define PROJECTILEPOOL_H
+#include "Projectile.h"
+
+namespace cb {
+
+	/*
+	Reference to a pooled projectile
+
+	`generation` must match the slot's current generation, so a handle kept after its shell was
+	despawned (and the slot reused) is detected as stale instead of reading someone else's shell.
+	*/
+	struct ProjectileHandle {
+		unsigned short index;
+		unsigned short generation;
+
+		ProjectileHandle() : index(0xFFFF), generation(0) {}
+		ProjectileHandle(unsigned short i, unsigned short g) : index(i), generation(g) {}
+		bool valid() const { return generation != 0; }
+	};
+
+	/*
+	Fixed-capacity storage for live projectiles
+
+	Slots are recycled through an intrusive free list, so firing and despawning are O(1) and
+	never touch the heap. When every slot is in use `acquire` returns an invalid handle.
+
+	Each slot also remembers its position in the owner's dense live list (`denseIndex`), so a
+	shell can be found and swap-removed from that list by handle without searching it.
+	*/
+	class ProjectilePool {
+	public:
+		static const unsigned short CAPACITY = 256;
+
+		ProjectilePool() {
+			for (unsigned short i = 0; i < CAPACITY; i++) {
+				generations[i] = 1;
+				nextFree[i] = i + 1;
+			}
+			freeHead = 0;
+			live = 0;
+		}
+		ProjectileHandle acquire(const Projectile& projectile) {
+			if (freeHead == CAPACITY)
+				return ProjectileHandle();
+			unsigned short index = freeHead;
+			freeHead = nextFree[index];
+			slots[index] = projectile;
+			dense[index] = live;
+			live++;
+			return ProjectileHandle(index, generations[index]);
+		}
+		void release(ProjectileHandle handle) {
+			if (!alive(handle))
+				return;
+			// skip generation 0 on wrap-around, it marks invalid handles
+			if (++generations[handle.index] == 0)
+				generations[handle.index] = 1;
+			nextFree[handle.index] = freeHead;
+			freeHead = handle.index;
+			live--;
+		}
+		bool alive(ProjectileHandle handle) const {
+			return handle.index < CAPACITY && handle.generation == generations[handle.index];
+		}
+		// the projectile behind `handle`, or null when the handle is stale
+		Projectile* get(ProjectileHandle handle) {
+			return alive(handle) ? &slots[handle.index] : nullptr;
+		}
+		unsigned short count() const { return live; }
+		// back-index into the owner's dense list; kept current by the owner when it moves entries
+		unsigned short denseIndex(ProjectileHandle handle) const { return dense[handle.index]; }
+		void setDenseIndex(ProjectileHandle handle, unsigned short index) { dense[handle.index] = index; }
+
+	private:
+		Projectile slots[CAPACITY];
+		unsigned short generations[CAPACITY];
+		unsigned short nextFree[CAPACITY];
+		unsigned short dense[CAPACITY];
+		unsigned short freeHead;
+		unsigned short live;
+	};
+
+}
+#endif
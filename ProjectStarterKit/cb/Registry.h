@@ -0,0 +1,36 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+namespace cb {
+
+	/*
+	The kinds of entity a world keeps, each in its own dense range
+	*/
+	enum EntityKind {
+		KIND_OBSTACLE,
+		KIND_TANK,
+		KIND_PROJECTILE
+	};
+
+	/*
+	Stable, typed reference to an entity of kind `Kind`
+
+	Obstacles and tanks are never removed from their range (dead tanks respawn in place), so the
+	index stays valid for the whole match. The kind is part of the type, so a tank id can not be
+	passed where an obstacle id is expected. Projectiles come and go and use `ProjectileHandle`.
+	*/
+	template <EntityKind Kind>
+	struct Id {
+		unsigned int index;
+
+		explicit Id(unsigned int i = 0xFFFFFFFF) : index(i) {}
+		bool valid() const { return index != 0xFFFFFFFF; }
+		bool operator==(const Id& other) const { return index == other.index; }
+		bool operator!=(const Id& other) const { return index != other.index; }
+	};
+
+	typedef Id<KIND_OBSTACLE> ObstacleId;
+	typedef Id<KIND_TANK> TankId;
+
+}
+#endif
@@ -0,0 +1,46 @@
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+namespace cb {
+
+	/*
+	Fixed-rate simulation clock
+
+	Real frame time is fed to `advance`, which returns how many whole ticks of `tickSeconds` are
+	due. Whatever is left over stays in the accumulator and `alpha` reports it as a 0..1 fraction
+	of a tick, which the renderer uses to blend between the last two simulated states. At most
+	`maxTicks` are handed out per call so one long stall cannot snowball into ever longer frames.
+	*/
+	class SimClock {
+	public:
+		SimClock(double tickSeconds, int maxTicks) {
+			step = tickSeconds;
+			maxTicksPerFrame = maxTicks;
+			accumulator = 0;
+			ticks = 0;
+		}
+		int advance(double secondsElapsed) {
+			accumulator += secondsElapsed;
+			int due = 0;
+			while (accumulator >= step && due < maxTicksPerFrame) {
+				accumulator -= step;
+				due++;
+			}
+			if (due == maxTicksPerFrame && accumulator >= step)
+				accumulator = 0;
+			ticks += due;
+			return due;
+		}
+		float alpha() const { return (float)(accumulator / step); }
+		double tickSeconds() const { return step; }
+		unsigned long long tick() const { return ticks; }
+
+	private:
+		double step;
+		double accumulator;
+		int maxTicksPerFrame;
+		unsigned long long ticks;
+	};
+
+}
+#endif
@@ -0,0 +1,46 @@
+#include "Simulation.h"
+#include <cmath>
+
+using namespace cb;
+
+// squared distance between the segments p1-q1 and p2-q2
+static float segmentDistanceSquared(glm::vec3 p1, glm::vec3 q1, glm::vec3 p2, glm::vec3 q2) {
+	glm::vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+	float a = glm::dot(d1, d1), e = glm::dot(d2, d2), f = glm::dot(d2, r);
+	float s = 0, t = 0;
+	if (a <= 1e-12f) {
+		t = e > 1e-12f ? glm::clamp(f / e, 0.0f, 1.0f) : 0;
+	}
+	else {
+		float c = glm::dot(d1, r);
+		if (e <= 1e-12f) {
+			s = glm::clamp(-c / a, 0.0f, 1.0f);
+		}
+		else {
+			float b = glm::dot(d1, d2);
+			float denom = a * e - b * b;
+			s = denom > 0 ? glm::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0;
+			t = (b * s + f) / e;
+			if (t < 0) {
+				t = 0;
+				s = glm::clamp(-c / a, 0.0f, 1.0f);
+			}
+			else if (t > 1) {
+				t = 1;
+				s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+			}
+		}
+	}
+	glm::vec3 gap = (p1 + d1 * s) - (p2 + d2 * t);
+	return glm::dot(gap, gap);
+}
+/*
+Whether a shell travelling from `from` to `to` during one tick touched the tank. The hit volume
+is a capsule of radius 1.6 around the body's long axis, one unit to the front and back of its
+center; testing the whole segment means a fast shell or a long tick can not skip past it.
+*/
+bool ProjectileCollide(Tank & t, glm::vec3 from, glm::vec3 to){
+	glm::vec3 center = t.getPosition();
+	glm::vec3 half(t.getYawSin(), 0, -t.getYawCos());
+	return segmentDistanceSquared(from, to, center - half, center + half) <= 1.6f * 1.6f;
+}
@@ -0,0 +1,66 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+#include "Transform.h"
+#include "EntityStore.h"
+#include "Tank.h"
+#include "Projectile.h"
+#include <vector>
+
+/*
+Game rules of a match
+
+Everything in here and in World is plain C++ and glm, with no GLEW/GLFW, so the same simulation
+runs inside the windowed game and inside the headless runner. Rendering only reads the entity
+pools.
+*/
+
+// per tick rates and ballistics
+const float TURN_RATE = 0.07;
+const float MOVEMENT_RATE = 0.03;
+const float MAX_ATTACK_DISTANCE = 40;
+const float PROJECTILE_SPEED = 30;
+const float GRAVITY = 1;
+const float TURRET_HORIZONTAL_RATE = 0.1f;
+const float TURRET_VERTICAL_RATE = 0.1f;
+// the simulation runs at a fixed rate; the *_RATE constants above are per tick
+const double TICK_SECONDS = 1.0 / 60.0;
+// delays counted in simulation ticks: 3 s between shots, a dead tank is back on the next tick
+const unsigned int RELOAD_TICKS = 180;
+const unsigned int RESPAWN_TICKS = 1;
+
+namespace cb {
+
+	/*
+	Assets the match hands to the entities it creates. All of them may be null when nothing
+	is going to draw the pools.
+	*/
+	struct MatchAssets {
+		ModelAsset* terrain;
+		ModelAsset* tank;
+		ModelAsset* turret;
+		ModelAsset* shell;
+	};
+
+	/*
+	What the player wants their tank to do during one tick
+	*/
+	struct TankControls {
+		bool forward, back, left, right;
+		bool fire;
+		bool damageEnemy, healEnemy;
+		float aimUp, aimRight;
+
+		TankControls() :
+			forward(false), back(false), left(false), right(false),
+			fire(false),
+			damageEnemy(false), healEnemy(false),
+			aimUp(0), aimRight(0)
+		{}
+	};
+
+}
+
+// collision and hit tests that only look at the entities they are given
+bool ProjectileCollide(cb::Tank & t, glm::vec3 from, glm::vec3 to);
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+#include "Arena.h"
+#include "EntityStore.h"
+#include "Registry.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace cb {
+
+	/*
+	Uniform grid over the XZ plane, hashed into a fixed number of buckets
+
+	Every entity is registered once as a proxy with its XZ bounds and is linked into each cell
+	those bounds cover. Moving a proxy only relinks it when its cell range actually changes, which
+	for a tank crawling MOVEMENT_RATE per tick is rare. Bucket lists are intrusive and their nodes
+	are recycled through a free list, so updates do not allocate once the pools are warm.
+
+	Far-apart cells can hash into the same bucket; every node remembers its cell, so those are
+	told apart. The hash also keeps the range of cells anything was ever linked into, and
+	searches skip the cells outside it. `query` reports a proxy only from the first queried cell it covers, which keeps
+	it free of per-call state: any number of threads can query at once, as long as nothing
+	inserts or updates meanwhile. `traverse` marks proxies as it goes and is single-threaded.
+	*/
+	class SpatialHash {
+	public:
+		struct Proxy {
+			EntityKind kind;
+			unsigned int index;
+			int minX, minZ, maxX, maxZ;
+			unsigned int firstNode;
+			unsigned int stamp;
+		};
+
+		SpatialHash(float cellSize, unsigned int bucketCount, Arena* arena = NULL) :
+			cell(cellSize),
+			mask(bucketCount - 1),
+			stamp(0),
+			freeNode(NONE),
+			usedMinX(INT_MAX),
+			usedMinZ(INT_MAX),
+			usedMaxX(INT_MIN),
+			usedMaxZ(INT_MIN),
+			heads(bucketCount, +NONE, ArenaAllocator<unsigned int>(arena)),
+			nodes(ArenaAllocator<Node>(arena)),
+			proxies(ArenaAllocator<Proxy>(arena))
+		{}
+		// `bucketCount` given to the constructor has to be a power of two
+		void reserve(size_t proxyCount, size_t cellsPerProxy) {
+			proxies.reserve(proxyCount);
+			nodes.reserve(proxyCount * cellsPerProxy);
+		}
+		// registers an entity covering the XZ rectangle [lo, hi]; returns its proxy
+		unsigned int insert(EntityKind kind, unsigned int index, glm::vec2 lo, glm::vec2 hi) {
+			Proxy p;
+			p.kind = kind;
+			p.index = index;
+			p.firstNode = NONE;
+			p.stamp = 0;
+			proxies.push_back(p);
+			unsigned int proxy = (unsigned int)(proxies.size() - 1);
+			cellRange(lo, hi, proxies[proxy].minX, proxies[proxy].minZ, proxies[proxy].maxX, proxies[proxy].maxZ);
+			link(proxy);
+			return proxy;
+		}
+		// moves a proxy to a new rectangle, relinking it only when it changed cells
+		void update(unsigned int proxy, glm::vec2 lo, glm::vec2 hi) {
+			int minX, minZ, maxX, maxZ;
+			cellRange(lo, hi, minX, minZ, maxX, maxZ);
+			Proxy& p = proxies[proxy];
+			if (minX == p.minX && minZ == p.minZ && maxX == p.maxX && maxZ == p.maxZ)
+				return;
+			unlink(proxy);
+			p.minX = minX;
+			p.minZ = minZ;
+			p.maxX = maxX;
+			p.maxZ = maxZ;
+			link(proxy);
+		}
+		/*
+		Calls `visit(proxy)` once for every proxy sharing a cell with [lo, hi]. Returning true
+		from `visit` stops the query; `query` then returns true as well.
+		*/
+		template <typename Visit>
+		bool query(glm::vec2 lo, glm::vec2 hi, Visit visit) const {
+			int minX, minZ, maxX, maxZ;
+			cellRange(lo, hi, minX, minZ, maxX, maxZ);
+			minX = std::max(minX, usedMinX);
+			minZ = std::max(minZ, usedMinZ);
+			for (int x = minX; x <= std::min(maxX, usedMaxX); x++) {
+				for (int z = minZ; z <= std::min(maxZ, usedMaxZ); z++) {
+					for (unsigned int n = heads[bucket(x, z)]; n != NONE; n = nodes[n].next) {
+						const Node& node = nodes[n];
+						if (node.x != x || node.z != z)
+							continue;
+						// only the first queried cell the proxy covers reports it
+						const Proxy& p = proxies[node.proxy];
+						if (x != std::max(p.minX, minX) || z != std::max(p.minZ, minZ))
+							continue;
+						if (visit(p))
+							return true;
+					}
+				}
+			}
+			return false;
+		}
+		/*
+		Finds up to `k` proxies nearest `p` within `radius` and writes their entity indices to
+		`found` and their squared distances to `foundSq`, nearest first; returns how many.
+		`distanceSq(proxy)` measures a proxy from `p` to some point inside its bounds, or returns
+		a negative value to leave it out.
+
+		Walks square rings of cells outward from the cell of `p` and stops as soon as nothing
+		in the rings further out can be nearer than the k-th proxy found. A proxy is reported
+		from the first ring it reaches, at the cell its bounds clamped to that ring start on,
+		so like `query` it needs no per-call state.
+		*/
+		template <typename Distance>
+		size_t nearest(glm::vec2 p, float radius, size_t k, unsigned int* found, float* foundSq, Distance distanceSq) const {
+			int cx = (int)std::floor(p.x / cell), cz = (int)std::floor(p.y / cell);
+			int rings = (int)std::ceil(radius / cell) + 1;
+			size_t n = 0;
+			int r = 0;
+			auto scan = [&](int x, int z) {
+				for (unsigned int m = heads[bucket(x, z)]; m != NONE; m = nodes[m].next) {
+					const Node& node = nodes[m];
+					if (node.x != x || node.z != z)
+						continue;
+					const Proxy& proxy = proxies[node.proxy];
+					if (x != std::max(proxy.minX, cx - r) || z != std::max(proxy.minZ, cz - r))
+						continue;
+					// already reported from an inner ring
+					if (r > 0 && proxy.maxX > cx - r && proxy.minX < cx + r && proxy.maxZ > cz - r && proxy.minZ < cz + r)
+						continue;
+					float d = distanceSq(proxy);
+					if (d < 0 || d > radius * radius || (n == k && d >= foundSq[k - 1]))
+						continue;
+					// insertion into the sorted list, dropping the furthest when it is full
+					size_t at = n < k ? n++ : k - 1;
+					for (; at > 0 && foundSq[at - 1] > d; at--) {
+						found[at] = found[at - 1];
+						foundSq[at] = foundSq[at - 1];
+					}
+					found[at] = proxy.index;
+					foundSq[at] = d;
+				}
+			};
+			for (; r <= rings && k > 0; r++) {
+				// `p` lies in the middle cell, so every cell of ring r is at least r - 1 cells away
+				float reach = (r - 1) * cell;
+				if (r > 0 && n == k && foundSq[k - 1] <= reach * reach)
+					break;
+				// the top and bottom row of the ring, then the two ends of the rows between
+				int minX = std::max(cx - r, usedMinX), maxX = std::min(cx + r, usedMaxX);
+				for (int x = minX; x <= maxX && cz - r >= usedMinZ; x++)
+					scan(x, cz - r);
+				for (int x = minX; x <= maxX && r > 0 && cz + r <= usedMaxZ; x++)
+					scan(x, cz + r);
+				for (int z = std::max(cz - r + 1, usedMinZ); z <= std::min(cz + r - 1, usedMaxZ); z++) {
+					if (cx - r >= usedMinX)
+						scan(cx - r, z);
+					if (cx + r <= usedMaxX)
+						scan(cx + r, z);
+				}
+				// nothing further out was ever linked
+				if (cx - r <= usedMinX && cx + r >= usedMaxX && cz - r <= usedMinZ && cz + r >= usedMaxZ)
+					break;
+			}
+			return n;
+		}
+		/*
+		Walks the cells crossed by the segment `from`-`to` in order and calls
+		`visit(proxy, entry)` once for every proxy found in them, where `entry` is the fraction of
+		the segment at which the cell was entered. Returning true from `visit` stops the walk,
+		so callers looking for the nearest hit can stop once `entry` passes their best one.
+		*/
+		template <typename Visit>
+		void traverse(glm::vec2 from, glm::vec2 to, Visit visit) {
+			int x = (int)std::floor(from.x / cell), z = (int)std::floor(from.y / cell);
+			int endX = (int)std::floor(to.x / cell), endZ = (int)std::floor(to.y / cell);
+			glm::vec2 d = to - from;
+			int stepX = d.x > 0 ? 1 : -1, stepZ = d.y > 0 ? 1 : -1;
+			const float never = 1e30f;
+			float nextX = d.x != 0 ? ((x + (stepX > 0 ? 1 : 0)) * cell - from.x) / d.x : never;
+			float nextZ = d.y != 0 ? ((z + (stepZ > 0 ? 1 : 0)) * cell - from.y) / d.y : never;
+			float deltaX = d.x != 0 ? cell / std::fabs(d.x) : never;
+			float deltaZ = d.y != 0 ? cell / std::fabs(d.y) : never;
+			float entry = 0;
+			stamp++;
+			for (;;) {
+				for (unsigned int n = heads[bucket(x, z)]; n != NONE; n = nodes[n].next) {
+					Proxy& p = proxies[nodes[n].proxy];
+					// a proxy can only be skipped once it was really seen in a crossed cell
+					if (p.stamp == stamp || x < p.minX || x > p.maxX || z < p.minZ || z > p.maxZ)
+						continue;
+					p.stamp = stamp;
+					if (visit(p, entry))
+						return;
+				}
+				if ((x == endX && z == endZ) || entry > 1)
+					return;
+				if (nextX < nextZ) {
+					entry = nextX;
+					nextX += deltaX;
+					x += stepX;
+				}
+				else {
+					entry = nextZ;
+					nextZ += deltaZ;
+					z += stepZ;
+				}
+			}
+		}
+		size_t count() const { return proxies.size(); }
+
+	private:
+		static const unsigned int NONE = 0xFFFFFFFF;
+
+		// one link of a bucket list; also chains together all cells of the same proxy
+		struct Node {
+			int x, z;
+			unsigned int proxy;
+			unsigned int bucket;
+			unsigned int prev, next;
+			unsigned int nextOfProxy;
+		};
+
+		void cellRange(glm::vec2 lo, glm::vec2 hi, int& minX, int& minZ, int& maxX, int& maxZ) const {
+			minX = (int)std::floor(lo.x / cell);
+			minZ = (int)std::floor(lo.y / cell);
+			maxX = (int)std::floor(hi.x / cell);
+			maxZ = (int)std::floor(hi.y / cell);
+		}
+		unsigned int bucket(int x, int z) const {
+			return ((unsigned int)x * 73856093u ^ (unsigned int)z * 19349663u) & mask;
+		}
+		void link(unsigned int proxy) {
+			Proxy& p = proxies[proxy];
+			for (int x = p.minX; x <= p.maxX; x++) {
+				for (int z = p.minZ; z <= p.maxZ; z++) {
+					unsigned int n;
+					if (freeNode != NONE) {
+						n = freeNode;
+						freeNode = nodes[n].next;
+					}
+					else {
+						nodes.push_back(Node());
+						n = (unsigned int)(nodes.size() - 1);
+					}
+					usedMinX = std::min(usedMinX, x);
+					usedMinZ = std::min(usedMinZ, z);
+					usedMaxX = std::max(usedMaxX, x);
+					usedMaxZ = std::max(usedMaxZ, z);
+					unsigned int b = bucket(x, z);
+					Node& node = nodes[n];
+					node.x = x;
+					node.z = z;
+					node.proxy = proxy;
+					node.bucket = b;
+					node.prev = NONE;
+					node.next = heads[b];
+					if (heads[b] != NONE)
+						nodes[heads[b]].prev = n;
+					heads[b] = n;
+					node.nextOfProxy = p.firstNode;
+					p.firstNode = n;
+				}
+			}
+		}
+		void unlink(unsigned int proxy) {
+			Proxy& p = proxies[proxy];
+			unsigned int n = p.firstNode;
+			while (n != NONE) {
+				Node& node = nodes[n];
+				if (node.prev != NONE)
+					nodes[node.prev].next = node.next;
+				else
+					heads[node.bucket] = node.next;
+				if (node.next != NONE)
+					nodes[node.next].prev = node.prev;
+				unsigned int following = node.nextOfProxy;
+				node.next = freeNode;
+				freeNode = n;
+				n = following;
+			}
+			p.firstNode = NONE;
+		}
+
+		float cell;
+		unsigned int mask;
+		unsigned int stamp;
+		unsigned int freeNode;
+		int usedMinX, usedMinZ, usedMaxX, usedMaxZ;	// cells anything was ever linked into
+		Column<unsigned int> heads;
+		Column<Node> nodes;
+		Column<Proxy> proxies;
+	};
+
+	// XZ rectangle enclosing the oriented box of `id`
+	inline void boundsXZ(const EntityStore& store, EntityId id, glm::vec2& lo, glm::vec2& hi) {
+		const glm::vec3& s = store.size[id];
+		glm::vec3 extent = glm::abs(store.Ax[id]) * s.x + glm::abs(store.Ay[id]) * s.y + glm::abs(store.Az[id]) * s.z;
+		glm::vec3 c = store.center[id];
+		lo = glm::vec2(c.x - extent.x, c.z - extent.z);
+		hi = glm::vec2(c.x + extent.x, c.z + extent.z);
+	}
+
+}
+#endif
@@ -19,47 +19,30 @@ namespace cb {
 		return result * _radius;
 	}
 
-	GLfloat * Sphere::render(int depth) {
-		Triangle triangle1(glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, 1));
-		Triangle triangle2(glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, 1));
-		Triangle triangle3(glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, -1));
-		Triangle triangle4(glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, -1));
-		Triangle triangle5(glm::vec3(-1, 0, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, -1));
-		Triangle triangle6(glm::vec3(1, 0, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, -1));
-		Triangle triangle7(glm::vec3(1, 0, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, 1));
-		Triangle triangle8(glm::vec3(-1, 0, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, 1));
+	size_t Sphere::scratchBytes(int depth) {
+		size_t size = 3 * 3 * (size_t)pow(4, depth);
+		// the eight faces, then the vertices with uv and normal added, plus alignment slack
+		return (size * 8 + size * 64 / 3) * sizeof(GLfloat) + 64;
+	}
 
-		GLfloat * triange1Data = triangle1.getTriangleData(depth);
-		GLfloat * triange2Data = triangle2.getTriangleData(depth);
-		GLfloat * triange3Data = triangle3.getTriangleData(depth);
-		GLfloat * triange4Data = triangle4.getTriangleData(depth);
-		GLfloat * triange5Data = triangle5.getTriangleData(depth);
-		GLfloat * triange6Data = triangle6.getTriangleData(depth);
-		GLfloat * triange7Data = triangle7.getTriangleData(depth);
-		GLfloat * triange8Data = triangle8.getTriangleData(depth);
+	GLfloat * Sphere::render(int depth, FrameArena& scratch) {
+		Triangle triangles[8] = {
+			Triangle(glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, 1)),
+			Triangle(glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, 1)),
+			Triangle(glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, -1)),
+			Triangle(glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, -1)),
+			Triangle(glm::vec3(-1, 0, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, -1)),
+			Triangle(glm::vec3(1, 0, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, -1)),
+			Triangle(glm::vec3(1, 0, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, 1)),
+			Triangle(glm::vec3(-1, 0, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, 1))
+		};
 
 		int size = 3 * 3 * pow(4, depth);
-		GLfloat * vertexData = new GLfloat[size * 8];
-
-		std::copy(triange1Data, triange1Data + size, vertexData);
-		std::copy(triange2Data, triange2Data + size, vertexData + size);
-		std::copy(triange3Data, triange3Data + size, vertexData + size * 2);
-		std::copy(triange4Data, triange4Data + size, vertexData + size * 3);
-		std::copy(triange5Data, triange5Data + size, vertexData + size * 4);
-		std::copy(triange6Data, triange6Data + size, vertexData + size * 5);
-		std::copy(triange7Data, triange7Data + size, vertexData + size * 6);
-		std::copy(triange8Data, triange8Data + size, vertexData + size * 7);
-
-		free(triange1Data);
-		free(triange2Data);
-		free(triange3Data);
-		free(triange4Data);
-		free(triange5Data);
-		free(triange6Data);
-		free(triange7Data);
-		free(triange8Data);
+		GLfloat * vertexData = scratch.scratch<GLfloat>(size * 8);
+		for (int i = 0; i < 8; i++)
+			triangles[i].getTriangleData(depth, vertexData + size * i);
 
-		GLfloat * vertexDataAugment = new GLfloat[size * 64 / 3];
+		GLfloat * vertexDataAugment = scratch.scratch<GLfloat>(size * 64 / 3);
 		for (int i = 0, k = 0; i < size * 8;i = i + 3, k = k + 8) {
 			//Normalize triangle according to center of sphere to achive concavity
 			glm::vec3 result = normalize(glm::vec3(vertexData[i], vertexData[i + 1], vertexData[i + 2]));
@@ -6,6 +6,7 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include "FrameArena.h"
 
 namespace cb {
 	class Sphere {
@@ -18,7 +19,10 @@ namespace cb {
 
 		Sphere();
 		Sphere(glm::vec4 color, glm::vec3 position, float radius);
-		GLfloat * render(int);
+		// vertex data (position, uv, normal) of the sphere, taken from `scratch`
+		GLfloat * render(int depth, FrameArena& scratch);
+		// scratch memory `render` needs at `depth`
+		static size_t scratchBytes(int depth);
 
 	};
 }
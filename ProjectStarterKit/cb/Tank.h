@@ -1,11 +1,26 @@
 #ifndef TANK_H
 #define TANK_H
-#include "Structures.h"
-#include <chrono>
-const double MIN_ATTACK_INTERVAL = 3000;
+#include "Transform.h"
+#include "EntityStore.h"
+#include "Trig.h"
 
 namespace cb {
 
+	// where the turret sits on the body, and the cannon's pivot on the turret
+	const float TURRET_HEIGHT = 0.25f;
+	const float CANNON_HEIGHT = 0.325f;
+	const float CANNON_REACH = 1;
+
+	/*
+	A tank made of three boxes in an EntityStore: body, turret and cannon
+
+	The parts form a hierarchy. The body is placed in the world, the turret sits on the body and
+	the cannon hangs off the turret, each with a local pose relative to its parent; the store
+	resolves the world matrices of all tanks in one pass per tick. Moving the tank only touches
+	the body's pose. The turret is aimed in world space, so its local yaw is the aim minus the
+	body yaw. Sines and cosines are cached whenever an angle changes, so poses are built
+	without trig.
+	*/
 	class Tank {
 	public:
 		Tank() {
@@ -13,104 +28,161 @@ namespace cb {
 			y = 0;
 			z = 0;
 			xzOrientation = 0;
-			body = nullptr;
-			turret = nullptr;
-			cannon = nullptr;
+			parts = nullptr;
+			body = 0;
+			turret = 0;
+			cannon = 0;
 
 			health = 100;
-			lastAttack = std::chrono::steady_clock::now();
+			loaded = false;
+			velocity = glm::vec3(0);
+			axesDirty = false;
+			setYaw(0);
+			setAim(0, 0);
+		}
+		Tank(EntityStore & store, float xPos, float yPos, float zPos, ModelAsset * bodyAsset, ModelAsset * turretAsset, ModelAsset * cannonAsset,float xz) {
+			parts = &store;
+			body = parts->create(bodyAsset, glm::vec3(xPos, yPos, zPos), glm::vec3(1.5, 0.5, 2));
+			turret = parts->create(turretAsset, glm::vec3(0, TURRET_HEIGHT, 0), glm::vec3(0.5, 0.75, 1), body);
+			cannon = parts->create(cannonAsset, glm::vec3(0, CANNON_HEIGHT, -CANNON_REACH), glm::vec3(0.1, 0.1, 1), turret);
+			respawn(xPos, yPos, zPos, xz);
 		}
-		Tank(GLfloat xPos, GLfloat yPos, GLfloat zPos, ModelAsset & bodyAsset, ModelAsset & turretAsset, ModelAsset & cannonAsset,GLfloat xz) {
+		// puts the tank back at full health on the given spot, reusing its slots in the store
+		void respawn(float xPos, float yPos, float zPos, float xz) {
 			x = xPos;
 			y = yPos;
 			z = zPos;
-			xzOrientation = xz;
-			body = new ModelInstance();
-			body->asset = &bodyAsset;
-			body->transform = translate(x, y, z)*scale(1.5, 0.5, 2);
-			body->setSize(1.5, 0.5, 2);
-			body->positionX = x;
-			body->positionY = y;
-			body->positionZ = z;
-
-			turret = new ModelInstance();
-			turret->asset = &turretAsset;
-			turret->transform = translate(x, y + 0.25, z)*scale(0.5, 0.75, 1);
-			turret->positionX = x;
-			turret->positionY = y + 0.25;
-			turret->positionZ = z;
-
-			cannon = new ModelInstance();
-			cannon->asset = &cannonAsset;
-			cannon->transform = translate(x, y+0.675, z - 1)*scale(0.1, 0.1, 1);
-			cannon->positionX = x;
-			cannon->positionY = y+0.675;
-			cannon->positionZ = z - 1;
+			setYaw(xz);
+			setAim(0, 0);
+			parts->position[body] = glm::vec3(x, y, z);
+			parts->yaw[body] = xzOrientation;
+			poseBody();
+			poseTurret();
+			poseCannon();
+			// a respawn is a teleport, so there is nothing to interpolate from
+			parts->teleport(body);
 
 			health = 100;
-			lastAttack = std::chrono::steady_clock::now();
-			body->setColllisionVectors(getTransformArray(*body));
-		}
-		void rotateBody(GLfloat turnRate) {
-			xzOrientation += turnRate;
-			body->transform = translate(body->positionX, body->positionY, body->positionZ)*rotate(glm::radians(xzOrientation), 0, 1, 0)*scale(1.5, 0.5, 2);
-		}
-		ModelInstance* GetBody() { return body; }
-		ModelInstance* GetTurret() { return turret; }
-		ModelInstance* GetCannon() { return cannon; }
-		void move(GLfloat movementRate) {
-			body->transform = translate(body->positionX + movementRate*glm::sin(glm::radians(-xzOrientation) ), body->positionY, body->positionZ - movementRate*glm::cos(glm::radians(xzOrientation)))*rotate(glm::radians(xzOrientation), 0, 1, 0)*scale(1.5, 0.5, 2);
-			body->setColllisionVectors(getTransformArray(*body));
-			body->setPosition(body->positionX + movementRate*glm::sin(glm::radians(-xzOrientation) ), body->positionY, body->positionZ - movementRate*glm::cos(glm::radians(xzOrientation)));
-			turret->setPosition(turret->positionX + movementRate*glm::sin(glm::radians(-xzOrientation) ), turret->positionY, turret->positionZ - movementRate*glm::cos(glm::radians(xzOrientation)));
-			cannon->setPosition(cannon->positionX + movementRate*(glm::sin(glm::radians(xzOrientation)) ), cannon->positionY+0.675, cannon->positionZ - movementRate*(1 - glm::cos(glm::radians(xzOrientation))));
-			moveTurret(upOrientation, rightOrientation);
-		}
-		void moveBack(GLfloat movementRate) {
-			body->transform = translate(body->positionX + movementRate*glm::sin(glm::radians(xzOrientation)), body->positionY, body->positionZ + movementRate*glm::cos(glm::radians(xzOrientation)))*rotate(glm::radians(xzOrientation), 0, 1, 0)*scale(1.5, 0.5, 2);
-		
-
-			body->setPosition(body->positionX + movementRate*glm::sin(glm::radians(xzOrientation)), body->positionY, body->positionZ + movementRate*glm::cos(glm::radians(xzOrientation)));
-			turret->setPosition(turret->positionX + movementRate*glm::sin(glm::radians(xzOrientation)), turret->positionY, turret->positionZ + movementRate*glm::cos(glm::radians(xzOrientation)));
-			cannon->setPosition(cannon->positionX + movementRate*glm::sin(glm::radians(xzOrientation)), cannon->positionY + 0.675, cannon->positionZ + movementRate*glm::cos(glm::radians(xzOrientation)));
-			moveTurret(upOrientation, rightOrientation);
-		
-		}
-		void moveTurret(GLfloat upAngle,GLfloat rightAngle) {
-			upOrientation = upAngle;
-			rightOrientation = rightAngle;
-			turret->transform = translate(turret->positionX, turret->positionY, turret->positionZ)*rotate(glm::radians(-rightOrientation), 0, 1, 0)*scale(0.5, 0.75, 1);
-			cannon->transform = translate(turret->positionX + glm::sin(glm::radians(rightOrientation)) + 0.01*(glm::sin(glm::radians(xzOrientation))), turret->positionY +0.325 - glm::sin(glm::radians(upOrientation)), turret->positionZ - (glm::cos(glm::radians(-rightOrientation))))*rotate(glm::radians(-rightOrientation), 0, 1, 0)*rotate(-glm::radians(upOrientation), 1, 0, 0)*scale(0.1, 0.1, 1);
-			cannon->setPosition(turret->positionX + glm::sin(glm::radians(rightOrientation)) + 0.01*(glm::sin(glm::radians(xzOrientation))), turret->positionY + 0.325 - glm::sin(glm::radians(upOrientation)), turret->positionZ - (glm::cos(glm::radians(-rightOrientation))));
+			loaded = false;
+			velocity = glm::vec3(0);
+			axesDirty = true;
+			calculateCollisionVectors();
+		}
+		void rotateBody(float turnRate) {
+			setYaw(xzOrientation + turnRate);
+			parts->yaw[body] = xzOrientation;
+			poseBody();
+			poseTurret();
+			axesDirty = true;
+		}
+		EntityStore* GetParts() { return parts; }
+		EntityId GetBody() { return body; }
+		EntityId GetTurret() { return turret; }
+		EntityId GetCannon() { return cannon; }
+		glm::vec3 getPosition() { return parts->position[body]; }
+		glm::vec3 getTurretPosition() { return parts->position[body] + glm::vec3(0, TURRET_HEIGHT, 0); }
+		void move(float movementRate) {
+			translateBy(glm::vec3(-movementRate*yawSin, 0, -movementRate*yawCos));
+		}
+		void moveBack(float movementRate) {
+			translateBy(glm::vec3(movementRate*yawSin, 0, movementRate*yawCos));
+		}
+		void moveTurret(float upAngle,float rightAngle) {
+			if (upAngle == upOrientation && rightAngle == rightOrientation)
+				return;
+			bool pitched = upAngle != upOrientation;
+			setAim(upAngle, rightAngle);
+			poseTurret();
+			if (pitched)
+				poseCannon();
 		}
 		void removeHealth(double dmg) {
 			health -= dmg;
 		}
+		// brings the body's collision box up to date, if it moved since the last call
 		void calculateCollisionVectors() {
-			body->setColllisionVectors(getTransformArray(*body));
-		}
-		bool Tank::shoot(){
-			std::chrono::steady_clock::time_point currentAttack = std::chrono::steady_clock::now();
-			double duration = std::chrono::duration_cast<std::chrono::milliseconds>(currentAttack - lastAttack).count();
-			if (duration > MIN_ATTACK_INTERVAL) {
-				lastAttack = currentAttack;
-				return true;;
-			}	
-			return false;
-		}
-		GLfloat getXZOrientation() { return xzOrientation;}
-		GLfloat getUpOrientation() { return upOrientation; }
-		GLfloat getRightOrientation() { return rightOrientation; }
+			if (!axesDirty)
+				return;
+			parts->Ax[body] = glm::vec3(yawCos, 0, -yawSin);
+			parts->Ay[body] = glm::vec3(0, 1, 0);
+			parts->Az[body] = glm::vec3(yawSin, 0, yawCos);
+			parts->center[body] = parts->position[body];
+			axesDirty = false;
+		}
+		// fires if a shell is loaded; the world schedules the next `reload`
+		bool shoot() {
+			if (!loaded)
+				return false;
+			loaded = false;
+			return true;
+		}
+		void reload() { loaded = true; }
+		bool isLoaded() { return loaded; }
+		float getXZOrientation() { return xzOrientation;}
+		// cached sine and cosine of the body yaw
+		float getYawSin() { return yawSin; }
+		float getYawCos() { return yawCos; }
+		float getUpOrientation() { return upOrientation; }
+		float getRightOrientation() { return rightOrientation; }
 		double getHealth() { return health; }
-		
+		// ground velocity per second over the tank's last drive; the world sets it after moving the tank
+		glm::vec3 getVelocity() { return velocity; }
+		void setVelocity(glm::vec3 v) { velocity = v; }
+		// shifts the whole tank by `offset`
+		void translateBy(glm::vec3 offset) {
+			parts->position[body] += offset;
+			poseBody();
+			axesDirty = true;
+		}
+
 	private:
-		ModelInstance* cannon, *turret, *body;
-		GLfloat x, y, z;
-		GLfloat xzOrientation=0;
-		GLfloat upOrientation = 0, rightOrientation = 0;
+		void setYaw(float xz) {
+			xzOrientation = xz;
+			sincosDeg(xz, yawSin, yawCos);
+			sincosDeg(rightOrientation + xzOrientation, turnSin, turnCos);
+		}
+		void setAim(float up, float right) {
+			upOrientation = up;
+			rightOrientation = right;
+			sincosDeg(up, pitchSin, pitchCos);
+			sincosDeg(rightOrientation + xzOrientation, turnSin, turnCos);
+		}
+		// yaw about Y, then the spot on the ground
+		void poseBody() {
+			glm::mat4 m;
+			m[0] = glm::vec4(yawCos, 0, -yawSin, 0);
+			m[2] = glm::vec4(yawSin, 0, yawCos, 0);
+			m[3] = glm::vec4(parts->position[body], 1);
+			parts->setLocal(body, m);
+		}
+		// turned by the aim relative to the body (a yaw of -(right + xz))
+		void poseTurret() {
+			glm::mat4 m;
+			m[0] = glm::vec4(turnCos, 0, turnSin, 0);
+			m[2] = glm::vec4(-turnSin, 0, turnCos, 0);
+			m[3] = glm::vec4(0, TURRET_HEIGHT, 0, 1);
+			parts->setLocal(turret, m);
+		}
+		// pitched by -up about its pivot, reaching CANNON_REACH forward of it
+		void poseCannon() {
+			glm::mat4 m;
+			m[1] = glm::vec4(0, pitchCos, -pitchSin, 0);
+			m[2] = glm::vec4(0, pitchSin, pitchCos, 0);
+			m[3] = glm::vec4(0, CANNON_HEIGHT - CANNON_REACH * pitchSin, -CANNON_REACH * pitchCos, 1);
+			parts->setLocal(cannon, m);
+		}
+
+		EntityStore* parts;
+		EntityId cannon, turret, body;
+		float x, y, z;
+		float xzOrientation=0;
+		float upOrientation = 0, rightOrientation = 0;
+		float yawSin, yawCos, pitchSin, pitchCos, turnSin, turnCos;
+		bool axesDirty;
 		double health;
-		std::chrono::steady_clock::time_point lastAttack;
-		
+		bool loaded;
+		glm::vec3 velocity;
+
 	};
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,119 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+#include "Arena.h"
+#include "EntityStore.h"
+
+namespace cb {
+
+	/*
+	Hierarchical timer wheel counting simulation ticks
+
+	Level 0 has one slot per tick for the next 64 ticks, and each level above covers 64 times the
+	span of the one below. A timer is filed once in the coarsest slot that still tells it apart,
+	and is moved down a level each time the wheel turns past that slot, so scheduling and firing
+	are O(1) no matter how many timers are pending. Timers far past the last level are parked in
+	it and re-filed until they come in range.
+
+	Timers can not be cancelled; whoever handles `fire` checks that the event still applies
+	(the tank is still waiting on that reload, the shell is still alive).
+	*/
+	class TimerWheel {
+	public:
+		struct Timer {
+			unsigned int due;
+			unsigned int kind;
+			unsigned int target;
+			unsigned int next;
+		};
+
+		TimerWheel(Arena* arena = NULL) :
+			now(0),
+			freeTimer(NONE),
+			timers(ArenaAllocator<Timer>(arena))
+		{
+			for (int level = 0; level < LEVELS; level++) {
+				for (int slot = 0; slot < SLOTS; slot++)
+					slots[level][slot] = NONE;
+			}
+		}
+		void reserve(size_t n) { timers.reserve(n); }
+		unsigned int current() const { return now; }
+		// fires `kind`/`target` on tick `due`; due ticks that already passed fire on the next one
+		void schedule(unsigned int due, unsigned int kind, unsigned int target) {
+			unsigned int t;
+			if (freeTimer != NONE) {
+				t = freeTimer;
+				freeTimer = timers[t].next;
+			}
+			else {
+				timers.push_back(Timer());
+				t = (unsigned int)(timers.size() - 1);
+			}
+			timers[t].due = (int)(due - now) > 0 ? due : now + 1;
+			timers[t].kind = kind;
+			timers[t].target = target;
+			file(t);
+		}
+		// turns the wheel up to tick `to`, calling `fire(timer)` for every timer that comes due
+		template <typename Fire>
+		void advance(unsigned int to, Fire fire) {
+			while ((int)(to - now) > 0) {
+				now++;
+				// pull the next stretch of each coarser level down, coarsest first
+				int top = 0;
+				while (top + 1 < LEVELS && (now & ((1u << (BITS * (top + 1))) - 1)) == 0)
+					top++;
+				for (int level = top; level > 0; level--)
+					cascade(level, (now >> (BITS * level)) & (SLOTS - 1));
+
+				unsigned int& head = slots[0][now & (SLOTS - 1)];
+				unsigned int t = head;
+				head = NONE;
+				while (t != NONE) {
+					unsigned int following = timers[t].next;
+					Timer timer = timers[t];
+					timers[t].next = freeTimer;
+					freeTimer = t;
+					fire(timer);
+					t = following;
+				}
+			}
+		}
+
+	private:
+		static const int LEVELS = 4;
+		static const int BITS = 6;
+		static const int SLOTS = 1 << BITS;
+		static const unsigned int NONE = 0xFFFFFFFF;
+
+		void file(unsigned int t) {
+			unsigned int due = timers[t].due;
+			unsigned int delta = due - now;
+			int level = 0;
+			while (level + 1 < LEVELS && delta >= (1u << (BITS * (level + 1))))
+				level++;
+			// past the top level: park it in the furthest slot, it gets re-filed from there
+			if (delta >= (1u << (BITS * LEVELS)))
+				due = now + (1u << (BITS * LEVELS)) - 1;
+			unsigned int& head = slots[level][(due >> (BITS * level)) & (SLOTS - 1)];
+			timers[t].next = head;
+			head = t;
+		}
+		void cascade(int level, unsigned int slot) {
+			unsigned int t = slots[level][slot];
+			slots[level][slot] = NONE;
+			while (t != NONE) {
+				unsigned int following = timers[t].next;
+				file(t);
+				t = following;
+			}
+		}
+
+		unsigned int now;
+		unsigned int freeTimer;
+		unsigned int slots[LEVELS][SLOTS];
+		Column<Timer> timers;
+	};
+
+}
+#endif
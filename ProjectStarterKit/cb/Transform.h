@@ -0,0 +1,35 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+/*
+Matrix and vector helpers shared by the renderer and the simulation
+
+Only depends on glm, so game logic that includes this instead of Structures.h builds without
+GLEW/GLFW.
+*/
+namespace cb {
+
+	// convenience function that returns a translation matrix
+	inline glm::mat4 translate(float x, float y, float z) {
+		return glm::translate(glm::mat4(), glm::vec3(x, y, z));
+	}
+
+
+	// convenience function that returns a scaling matrix
+	inline glm::mat4 scale(float x, float y, float z) {
+		return glm::scale(glm::mat4(), glm::vec3(x, y, z));
+	}
+
+	inline glm::mat4 rotate(float angle, float x, float y, float z) {
+		return glm::rotate(glm::mat4(), angle, glm::vec3(x, y, z));
+	}
+
+	inline glm::vec3 multiply(float a, glm::vec3 vec) {
+		glm::vec3 newVec(a*vec.x, a*vec.y, a*vec.z);
+		return newVec;
+	}
+
+}
+#endif
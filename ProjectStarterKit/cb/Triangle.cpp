@@ -13,11 +13,9 @@ namespace cb {
 	{
 	}
 
-	GLfloat * Triangle::subdivide(float depth, glm::vec3 x, glm::vec3 y, glm::vec3 z) {
+	void Triangle::subdivide(float depth, glm::vec3 x, glm::vec3 y, glm::vec3 z, GLfloat* result) {
 		//End of the recursion
 		if (depth == 0) {
-			GLfloat * result = new GLfloat[3 * 3];
-
 			result[0] = x.x;
 			result[1] = x.y;
 			result[2] = x.z;
@@ -29,28 +27,19 @@ namespace cb {
 			result[6] = z.x;
 			result[7] = z.y;
 			result[8] = z.z;
-
-			return result;
+			return;
 		}
 
-		GLfloat * upper = subdivide(depth - 1, x, (x + y) / 2.0f, (x + z) / 2.0f);
-		GLfloat * left = subdivide(depth - 1, y, (x + y) / 2.0f, (y + z) / 2.0f);
-		GLfloat * right = subdivide(depth - 1, z, (x + z) / 2.0f, (y + z) / 2.0f);
-		GLfloat * middle = subdivide(depth - 1, (x + y) / 2.0f, (x + z) / 2.0f, (y + z) / 2.0f);
-
-		GLfloat * result = new GLfloat[(int)pow(4, depth) * 9];
-
+		// each quarter is written straight to its place in the output
 		int size = (int)pow(4, depth - 1) * 9;
-		std::copy(upper, upper + size, result);
-		std::copy(left, left + size, result + size);
-		std::copy(right, right + size, result + size + size);
-		std::copy(middle, middle + size, result + size + size + size);
-
-		return result;
+		subdivide(depth - 1, x, (x + y) / 2.0f, (x + z) / 2.0f, result);
+		subdivide(depth - 1, y, (x + y) / 2.0f, (y + z) / 2.0f, result + size);
+		subdivide(depth - 1, z, (x + z) / 2.0f, (y + z) / 2.0f, result + size + size);
+		subdivide(depth - 1, (x + y) / 2.0f, (x + z) / 2.0f, (y + z) / 2.0f, result + size + size + size);
 	}
 
-	GLfloat * Triangle::getTriangleData(float depth) {
-		return subdivide(depth, _x, _y, _z);
+	void Triangle::getTriangleData(float depth, GLfloat* out) {
+		subdivide(depth, _x, _y, _z, out);
 	}
 
 }
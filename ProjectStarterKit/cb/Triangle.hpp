@@ -10,11 +10,12 @@ namespace cb {
 	class Triangle {
 	private:
 		glm::vec3 _x, _y, _z;
-		GLfloat * subdivide(float depth, glm::vec3 x, glm::vec3 y, glm::vec3 z);
+		void subdivide(float depth, glm::vec3 x, glm::vec3 y, glm::vec3 z, GLfloat* out);
 	public:
 		Triangle();
 		Triangle(glm::vec3 x, glm::vec3 y, glm::vec3 z);
-		GLfloat* getTriangleData(float depth);
+		// writes the 4^depth triangles of the subdivided triangle to `out`, nine floats each
+		void getTriangleData(float depth, GLfloat* out);
 	};
 
 }
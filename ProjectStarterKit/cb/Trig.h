@@ -0,0 +1,79 @@
+#ifndef TRIG_H
+#define TRIG_H
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/*
+Sine and cosine of angles given in degrees, which is how every angle in the game is stored
+
+The angle is folded to the nearest multiple of 90 degrees first. That step is exact in degrees,
+so large angles (a tank that kept turning) lose no precision, and what is left lies in
+[-45, 45] where short polynomials do. The kernels have no branches or calls, so loops over
+`sincosDeg(degrees, sines, cosines, n)` vectorize (GCC wants -fno-trapping-math for the
+float-to-int step, MSVC /fp:fast).
+*/
+namespace cb {
+
+	namespace trig {
+		const float RADIANS_PER_DEGREE = 0.017453292519943295f;
+
+		// splits `degrees` into a quarter turn count and radians in [-pi/4, pi/4]
+		inline int fold(float degrees, float& x) {
+			float quarters = std::floor(degrees * (1.0f / 90) + 0.5f);
+			x = (degrees - quarters * 90) * RADIANS_PER_DEGREE;
+			return (int)quarters;
+		}
+		// rotates the first-quadrant pair by `quarter` quarter turns
+		inline void unfold(int quarter, float s, float c, float& sine, float& cosine) {
+			// arithmetic instead of selects, which keeps loops over it free of branches
+			float swap = (float)(quarter & 1);
+			float sinSign = 1 - (float)(quarter & 2);
+			float cosSign = 1 - (float)((quarter + 1) & 2);
+			sine = (s + swap * (c - s)) * sinSign;
+			cosine = (c + swap * (s - c)) * cosSign;
+		}
+	}
+
+	// sine and cosine of `degrees` to within 5e-7
+	inline void sincosDeg(float degrees, float& sine, float& cosine) {
+		float x;
+		int quarter = trig::fold(degrees, x);
+		float x2 = x * x;
+		float s = x * (1 + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040))));
+		float c = 1 + x2 * (-0.5f + x2 * (1.0f / 24 + x2 * (-1.0f / 720 + x2 * (1.0f / 40320))));
+		trig::unfold(quarter, s, c, sine, cosine);
+	}
+	// cheaper sine and cosine of `degrees` to within 4e-5, for decisions rather than state
+	inline void sincosDegFast(float degrees, float& sine, float& cosine) {
+		float x;
+		int quarter = trig::fold(degrees, x);
+		float x2 = x * x;
+		float s = x * (1 + x2 * (-1.0f / 6 + x2 * (1.0f / 120)));
+		float c = 1 + x2 * (-0.5f + x2 * (1.0f / 24 + x2 * (-1.0f / 720)));
+		trig::unfold(quarter, s, c, sine, cosine);
+	}
+	/*
+	Angle of the vector (x, y) from the x axis, in degrees in [-180, 180], to within 2e-4
+
+	Like the sincos kernels it has no branches, so it vectorizes inside loops.
+	*/
+	inline float atan2Deg(float y, float x) {
+		float ax = std::fabs(x), ay = std::fabs(y);
+		float a = std::min(ax, ay) / std::max(std::max(ax, ay), 1e-30f);
+		float a2 = a * a;
+		float r = a * (0.99997726f + a2 * (-0.33262347f + a2 * (0.19354346f + a2 * (-0.11643287f + a2 * (0.05265332f + a2 * -0.01172120f)))));
+		r *= 1 / trig::RADIANS_PER_DEGREE;
+		// out of the first octant: mirror about 45 degrees, then about the y axis, then the x axis
+		r += (float)(ay > ax) * (90 - 2 * r);
+		r += (float)(x < 0) * (180 - 2 * r);
+		return std::copysign(r, y);
+	}
+	// sines and cosines of `n` angles in degrees
+	inline void sincosDeg(const float* degrees, float* sines, float* cosines, size_t n) {
+		for (size_t i = 0; i < n; i++)
+			sincosDeg(degrees[i], sines[i], cosines[i]);
+	}
+
+}
+#endif
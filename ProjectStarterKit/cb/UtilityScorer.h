@@ -0,0 +1,138 @@
+#ifndef UTILITYSCORER_H
+#define UTILITYSCORER_H
+#include "Arena.h"
+#include "EntityStore.h"
+#include <algorithm>
+
+namespace cb {
+
+	// what an AI tank does about the enemies around it until it next thinks
+	enum AIAction {
+		AI_ENGAGE,		// holds its ground and shoots
+		AI_FLANK,		// circles a target that has it in its sights
+		AI_RETREAT,		// backs away from the nearest enemy
+		AI_REPOSITION,	// closes in on a target out of range
+		AI_ACTION_COUNT
+	};
+
+	/*
+	Utility scores of the actions of many AI tanks at once
+
+	Tank i is described by its own health and reload, the allies around it, and up to CANDIDATES
+	enemies nearest it: how far each is in weapon ranges, its health, and how squarely its turret
+	points back. `score` rates engaging, flanking and closing in on every candidate and retreating
+	from the nearest one, and keeps the best action with its candidate. A tank without candidates
+	repositions towards no one; the caller picks where to then.
+
+	Tanks are stored a block of LANES at a time like FiringSolver's pairs, and scored with
+	multiplies, clamps and selects only, so the loop over a block's lanes vectorizes too.
+	*/
+	class UtilityScorer {
+	public:
+		static const int LANES = 8;
+		static const int CANDIDATES = 4;
+
+		struct Block {
+			// inputs: fractions of full health, 1 or 0 for loaded and valid
+			float health[LANES], loaded[LANES];
+			float allies[LANES];
+			float range[CANDIDATES][LANES];			// distance in units of MAX_ATTACK_DISTANCE
+			float targetHealth[CANDIDATES][LANES];
+			float threat[CANDIDATES][LANES];		// cosine between its turret and the way to us, at least 0
+			float valid[CANDIDATES][LANES];
+			// outputs: an AIAction, a candidate or -1
+			float action[LANES], target[LANES], score[LANES];
+		};
+
+		UtilityScorer(Arena* arena = NULL) : count(0), blocks(ArenaAllocator<Block>(arena)) {}
+		void reserve(size_t tanks) { blocks.reserve((tanks + LANES - 1) / LANES); }
+		// makes room for `tanks` tanks; describe each of them with `sense` before scoring
+		void resize(size_t tanks) {
+			count = tanks;
+			blocks.resize((tanks + LANES - 1) / LANES);
+		}
+		size_t size() const { return count; }
+		size_t blockCount() const { return blocks.size(); }
+
+		// describes tank `i` and clears its candidates; health is a fraction of full health
+		void sense(size_t i, float health, bool loaded, int allies) {
+			Block& b = blocks[i / LANES];
+			int lane = (int)(i % LANES);
+			b.health[lane] = clamp01(health);
+			b.loaded[lane] = loaded ? 1.0f : 0.0f;
+			b.allies[lane] = (float)allies;
+			for (int c = 0; c < CANDIDATES; c++) {
+				b.range[c][lane] = 0;
+				b.targetHealth[c][lane] = 0;
+				b.threat[c][lane] = 0;
+				b.valid[c][lane] = 0;
+			}
+		}
+		// enemy `c` of tank `i`, nearest first
+		void candidate(size_t i, int c, float range, float targetHealth, float threat) {
+			Block& b = blocks[i / LANES];
+			int lane = (int)(i % LANES);
+			b.range[c][lane] = range;
+			b.targetHealth[c][lane] = clamp01(targetHealth);
+			b.threat[c][lane] = clamp01(threat);
+			b.valid[c][lane] = 1;
+		}
+		// scores the tanks in blocks [begin, end); ranges of blocks that do not overlap can be
+		// scored in parallel
+		void score(size_t begin, size_t end) {
+			for (size_t k = begin; k < end; k++)
+				scoreBlock(blocks[k], (int)std::min(count - k * LANES, (size_t)LANES));
+		}
+
+		AIAction action(size_t i) const { return (AIAction)(int)blocks[i / LANES].action[i % LANES]; }
+		// candidate the action is about, or -1
+		int target(size_t i) const { return (int)blocks[i / LANES].target[i % LANES]; }
+
+	private:
+		static float clamp01(float x) { return std::min(1.0f, std::max(0.0f, x)); }
+
+		static void scoreBlock(Block& b, int lanes) {
+			for (int i = 0; i < lanes; i++) {
+				float health = b.health[i];
+				// an empty gun halves the worth of standing and shooting, and of drawing fire
+				float ready = 0.5f + 0.5f * b.loaded[i];
+				float best = 0, action = (float)AI_REPOSITION, target = -1;
+				float enemies = 0;
+				for (int c = 0; c < CANDIDATES; c++) {
+					float valid = b.valid[c][i], range = b.range[c][i];
+					float inRange = (float)(range < 1);
+					enemies += valid * inRange;
+					// weak targets are worth more, and more so to a healthy tank
+					float engage = valid * inRange * (0.3f + 0.4f * (1 - b.targetHealth[c][i])) * (0.4f + 0.6f * health) * ready;
+					// a target aiming this way is better circled while reloading
+					float flank = valid * b.threat[c][i] * clamp01(1.5f - range) * (0.2f + 0.4f * health) * (1.5f - ready);
+					// nearer targets out of range first
+					float reposition = valid * 0.4f * clamp01((range - 0.8f) * 5) / std::max(range, 1.0f);
+					float c1 = (float)c;
+					target = engage > best ? c1 : target;
+					action = engage > best ? (float)AI_ENGAGE : action;
+					best = std::max(best, engage);
+					target = flank > best ? c1 : target;
+					action = flank > best ? (float)AI_FLANK : action;
+					best = std::max(best, flank);
+					target = reposition > best ? c1 : target;
+					action = reposition > best ? (float)AI_REPOSITION : action;
+					best = std::max(best, reposition);
+				}
+				// hurt and outnumbered tanks fall back from the nearest enemy
+				float retreat = b.valid[0][i] * clamp01(1.2f * (1 - health) + 0.15f * (enemies - b.allies[i]) - 0.3f);
+				target = retreat > best ? 0.0f : target;
+				action = retreat > best ? (float)AI_RETREAT : action;
+				best = std::max(best, retreat);
+				b.action[i] = action;
+				b.target[i] = target;
+				b.score[i] = best;
+			}
+		}
+
+		size_t count;
+		Column<Block> blocks;
+	};
+
+}
+#endif
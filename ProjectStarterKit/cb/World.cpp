@@ -0,0 +1,649 @@
+#include "World.h"
+#include "AllocCounter.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace cb;
+
+// capacity reserved up front in every pool, so a world running in an arena never regrows
+const size_t RESERVED_OBSTACLES = 64;
+const size_t RESERVED_TANKS = 64;
+const size_t RESERVED_TANK_PARTS = RESERVED_TANKS * 3;
+const size_t RESERVED_SHELLS = ProjectilePool::CAPACITY;
+const size_t TICK_SCRATCH_BYTES = 64 * 1024;
+// work per job in the parallel part of a tick; below this, splitting costs more than it saves
+const size_t SHELLS_PER_JOB = 64;
+const size_t AI_TANKS_PER_JOB = 16;
+static_assert(AI_TANKS_PER_JOB % UtilityScorer::LANES == 0, "AI jobs score whole blocks of tanks");
+
+// most AI tanks that think in one tick; the rest keep following their last orders
+const unsigned int AI_THINK_BUDGET = 256;
+// AI tanks this close to their target think every tick, those within AI_NEAR_RADIUS every few
+const float AI_COMBAT_RADIUS = 2 * MAX_ATTACK_DISTANCE;
+const float AI_NEAR_RADIUS = 200;
+// AI tanks weigh up the enemies this close to them; with none, they go after the player
+const float AI_SIGHT_RADIUS = AI_COMBAT_RADIUS;
+// health a tank spawns with, which the AI measures health against
+const float AI_FULL_HEALTH = 100;
+// an AI tank on the player's side with no enemy in sight keeps within this of the player
+const float AI_ESCORT_DISTANCE = 20;
+// an AI tank that fired or got hit keeps thinking every tick for this long
+const unsigned int AI_COMBAT_TICKS = RELOAD_TICKS;
+// nav grid around the origin, wide enough for every spawn; off it AI tanks head straight for the player
+const float NAV_CELL_SIZE = 2;
+const int NAV_CELLS = 160;
+// half the diagonal of a tank body, which crates are grown by on the nav grid
+const float NAV_CLEARANCE = 2.5f;
+// cells of a flow field built per tick, so following the player costs the same every tick
+const size_t NAV_CELLS_PER_TICK = 8192;
+// sine of one tick's body turn; an AI tank heading closer than that to where it wants to go drives straight
+const float AI_TURN_SIN = std::sin(TURN_RATE * trig::RADIANS_PER_DEGREE);
+
+// broadphase cells are a few tank lengths wide, so a body rarely covers more than four
+const float BROADPHASE_CELL_SIZE = 8;
+const unsigned int BROADPHASE_BUCKETS = 1024;
+const size_t BROADPHASE_CELLS_PER_PROXY = 4;
+// extra distance a resolved tank is pushed, so it does not end the tick touching the box
+const float CONTACT_SKIN = 0.001f;
+// separating-axis cache keys: tanks by index, crates by index with this bit set
+const unsigned int OBSTACLE_PAIR_BIT = 0x80000000;
+// shells are removed once they sink this far below the ground
+const float SHELL_FLOOR = -1;
+// a shell can only touch a tank within this XZ distance of its body center (see ProjectileCollide)
+const float TANK_HIT_REACH = 1 + 1.6f;
+// tanks drive on the ground, so shells higher than this can not hit any of them
+const float TANK_HIT_CEILING = 0.5f + 1.6f;
+
+World::World(Arena* arena) :
+	terminated(false),
+	tick(0),
+	respawnCount(5),
+	score(0),
+	scenery(arena),
+	obstacles(arena),
+	tankParts(arena),
+	shells(arena),
+	tanks(ArenaAllocator<Tank>(arena)),
+	respawnPoints(ArenaAllocator<glm::vec3>(arena)),
+	teams(ArenaAllocator<unsigned char>(arena)),
+	aiTanks(ArenaAllocator<TankId>(arena)),
+	aiSlots(ArenaAllocator<unsigned int>(arena)),
+	ai(AI_THINK_BUDGET, arena),
+	nav(NAV_CELL_SIZE, NAV_CELLS, arena),
+	chase(nav, arena),
+	tactics(arena),
+	gunnery(arena),
+	broadphase(BROADPHASE_CELL_SIZE, BROADPHASE_BUCKETS, arena),
+	tankProxies(ArenaAllocator<unsigned int>(arena)),
+	projectiles(ArenaAllocator<ProjectileHandle>(arena)),
+	timers(arena),
+	reloadDue(ArenaAllocator<unsigned int>(arena)),
+	tickScratch(TICK_SCRATCH_BYTES, arena),
+	jobs(NULL),
+	tickSeconds((float)TICK_SECONDS),
+	shellsMoved(false)
+{
+	scenery.reserve(1);
+	obstacles.reserve(RESERVED_OBSTACLES);
+	tankParts.reserve(RESERVED_TANK_PARTS);
+	tanks.reserve(RESERVED_TANKS);
+	respawnPoints.reserve(RESERVED_TANKS);
+	teams.reserve(RESERVED_TANKS);
+	aiTanks.reserve(RESERVED_TANKS);
+	aiSlots.reserve(RESERVED_TANKS);
+	ai.reserve(RESERVED_TANKS);
+	tactics.reserve(AI_THINK_BUDGET);
+	gunnery.reserve(AI_THINK_BUDGET);
+	tankProxies.reserve(RESERVED_TANKS);
+	broadphase.reserve(RESERVED_OBSTACLES + RESERVED_TANKS, BROADPHASE_CELLS_PER_PROXY);
+	shells.reserve(RESERVED_SHELLS);
+	projectiles.reserve(RESERVED_SHELLS);
+	reloadDue.reserve(RESERVED_TANKS);
+	timers.reserve(RESERVED_SHELLS * 2 + RESERVED_TANKS * 2);
+	tickGraph.reserve(RESERVED_SHELLS / SHELLS_PER_JOB + AI_THINK_BUDGET / AI_TANKS_PER_JOB * 2 + 8, RESERVED_SHELLS / SHELLS_PER_JOB + AI_THINK_BUDGET / AI_TANKS_PER_JOB * 4 + 8);
+	assets = MatchAssets();
+}
+
+ObstacleId World::AddObstacle(float x, float y, float z) {
+	EntityId crate = obstacles.create(assets.tank, glm::vec3(x, y, z), glm::vec3(1, 1, 1));
+	obstacles.updateCollisionVectors(crate);
+	glm::vec2 lo, hi;
+	boundsXZ(obstacles, crate, lo, hi);
+	broadphase.insert(KIND_OBSTACLE, crate, lo, hi);
+	nav.block(lo - glm::vec2(NAV_CLEARANCE), hi + glm::vec2(NAV_CLEARANCE));
+	return ObstacleId(crate);
+}
+
+TankId World::AddTank(glm::vec3 spawn, float xz, glm::vec3 respawn, bool ai, unsigned char team) {
+	TankId id((unsigned int)tanks.size());
+	tanks.push_back(Tank(tankParts, spawn.x, spawn.y, spawn.z, assets.tank, assets.turret, assets.tank, xz));
+	respawnPoints.push_back(respawn);
+	teams.push_back(team);
+	glm::vec2 lo, hi;
+	boundsXZ(tankParts, tanks.back().GetBody(), lo, hi);
+	tankProxies.push_back(broadphase.insert(KIND_TANK, id.index, lo, hi));
+	reloadDue.push_back(0);
+	ScheduleReload(id);
+	aiSlots.push_back(ai ? this->ai.add(tick) : NO_AI_SLOT);
+	if (ai)
+		aiTanks.push_back(id);
+	return id;
+}
+
+void World::CreateInstances(const MatchAssets& matchAssets) {
+	assets = matchAssets;
+	scenery.create(assets.terrain, glm::vec3(-1024, 0, -1024), glm::vec3(2048, 0, 2048));
+
+	player = AddTank(glm::vec3(0, 0.5, 0), 0, glm::vec3(0, 0.5, 0), false, PLAYER_TEAM);
+
+	TankId enemy = AddTank(glm::vec3(0, 0.5, -120), 0, glm::vec3(0, 0.5, 120), true, ENEMY_TEAM);
+	AddTank(glm::vec3(0, 0.5, 120), 0, glm::vec3(0, 0.5, -120), true, ENEMY_TEAM);
+
+	GetTank(enemy).moveTurret(-10, 0);
+
+	AddObstacle(-5, 1, -10);
+	AddObstacle(5, 1, -10);
+	AddObstacle(0, 1, -10);
+
+	UpdateTransforms();
+	glm::vec3 target = GetPlayer().getPosition();
+	chase.rebuild(nav.nearestCell(glm::vec2(target.x, target.z)));
+}
+
+// advances the player's tank by one simulation tick from the held controls and the aim
+void World::UpdatePlayer(const TankControls& controls) {
+	Tank& pTank = GetPlayer();
+	glm::vec3 from = pTank.getPosition();
+	if (controls.back) {
+		pTank.moveBack(MOVEMENT_RATE);
+	}
+	else if (controls.forward) {
+		pTank.move(MOVEMENT_RATE);
+	}
+	if (controls.left) {
+		pTank.rotateBody(TURN_RATE);
+	}
+	else if (controls.right) {
+		pTank.rotateBody(-TURN_RATE);
+	}
+	ResolvePenetration(player);
+	pTank.setVelocity((pTank.getPosition() - from) / tickSeconds);
+	if (controls.damageEnemy && !aiTanks.empty()) {
+		Damage(aiTanks[0], 100);
+	}
+	else if (controls.healEnemy && !aiTanks.empty()) {
+		Damage(aiTanks[0], -10);
+	}
+	else if (controls.fire) {
+		Fire(player);
+	}
+	pTank.moveTurret(controls.aimUp, controls.aimRight);
+}
+
+void World::SimulationTick(float seconds, const TankControls& controls, bool aiEnabled) {
+	tick++;
+	tickScratch.beginFrame();
+	tickSeconds = seconds;
+	shellsMoved = false;
+	scenery.snapshot();
+	obstacles.snapshot();
+	tankParts.snapshot();
+	shells.snapshot();
+
+	{
+		AllocPhaseScope phase(PHASE_UPDATE);
+		UpdatePlayer(controls);
+		timers.advance(tick, [&](const TimerWheel::Timer& timer) {
+			OnTimer(timer);
+		});
+	}
+
+	/*
+	Shells move and the AI tanks whose turn it is think in parallel over ranges; everything that
+	changes shared state (damage, despawns, driving, firing) is merged afterwards in index order,
+	so a tick plays out the same on any number of workers.
+	*/
+	// last tick's build of the chase field goes live, and a new one starts if the player changed cells
+	glm::vec3 target = GetPlayer().getPosition();
+	chase.swap();
+	chase.retarget(nav.nearestCell(glm::vec2(target.x, target.z)));
+
+	size_t shellCount = projectiles.size();
+	size_t aiCount = aiEnabled ? aiTanks.size() : 0;
+	TankId* hits = tickScratch.scratch<TankId>(shellCount);
+	unsigned int* thinkers = tickScratch.scratch<unsigned int>(std::min(aiCount, (size_t)ai.budget));
+	size_t thinkerCount = aiEnabled ? ai.schedule(tick, thinkers) : 0;
+	unsigned int* sighted = tickScratch.scratch<unsigned int>(thinkerCount * UtilityScorer::CANDIDATES);
+	tactics.resize(thinkerCount);
+	gunnery.resize(thinkerCount);
+	shellsMoved = true;
+	auto moveShells = [&](size_t begin, size_t end) {
+		AllocPhaseScope phase(PHASE_PROJECTILES);
+		for (size_t i = begin; i < end; i++)
+			hits[i] = MoveShell(i, seconds);
+	};
+	auto landShells = [&](size_t, size_t) {
+		AllocPhaseScope phase(PHASE_PROJECTILES);
+		LandShells(hits);
+	};
+	// a range of thinkers is whole blocks of tactics, so each range scores its blocks in one pass
+	// between looking around and acting on the scores
+	auto think = [&](size_t begin, size_t end) {
+		AllocPhaseScope phase(PHASE_AI);
+		for (size_t i = begin; i < end; i++)
+			AISense(thinkers[i], i, sighted);
+		tactics.score(begin / UtilityScorer::LANES, (end + UtilityScorer::LANES - 1) / UtilityScorer::LANES);
+		for (size_t i = begin; i < end; i++)
+			AIThink(thinkers[i], i, sighted);
+	};
+	// every firing solution of the tick is solved in one pass over blocks of shots
+	auto aim = [&](size_t begin, size_t end) {
+		AllocPhaseScope phase(PHASE_AI);
+		gunnery.solve(begin, end, PROJECTILE_SPEED, GRAVITY);
+		size_t last = std::min(end * FiringSolver::LANES, thinkerCount);
+		for (size_t i = begin * FiringSolver::LANES; i < last; i++)
+			AIAim(thinkers[i], i);
+	};
+	auto drive = [&](size_t, size_t) {
+		AllocPhaseScope phase(PHASE_AI);
+		for (size_t slot = 0; slot < aiCount; slot++)
+			AIDrive((unsigned int)slot);
+	};
+	// tanks only read the live field, so the next one is built alongside everything else
+	auto buildChase = [&](size_t, size_t) {
+		AllocPhaseScope phase(PHASE_AI);
+		chase.advance(NAV_CELLS_PER_TICK);
+	};
+	tickGraph.clear();
+	tickGraph.add(buildChase);
+	unsigned int moved = tickGraph.addRange(moveShells, shellCount, SHELLS_PER_JOB);
+	unsigned int landed = tickGraph.add(landShells);
+	tickGraph.precede(moved, landed);
+	// thinking reads health, so it waits for this tick's hits
+	unsigned int thought = tickGraph.addRange(think, thinkerCount, AI_TANKS_PER_JOB, landed);
+	unsigned int aimed = tickGraph.addRange(aim, gunnery.blockCount(), AI_TANKS_PER_JOB / FiringSolver::LANES, thought);
+	unsigned int driven = tickGraph.add(drive);
+	tickGraph.precede(aimed, driven);
+	runGraph(jobs, tickGraph);
+
+	AllocPhaseScope phase(PHASE_UPDATE);
+	UpdateTransforms();
+}
+// resolves the world matrices of every tank part whose pose changed this tick, once per tick
+void World::UpdateTransforms() {
+	tankParts.resolveTransforms();
+}
+
+/*
+Looks around for AI slot `slot`, the `i`-th tank thinking this tick: writes the enemies nearest
+it to its CANDIDATES entries of `sighted` and describes them, and how it stands against them,
+to `tactics`. Only reads the world and writes its own entries, so any number of tanks sense in
+parallel.
+*/
+void World::AISense(unsigned int slot, size_t i, unsigned int* sighted) {
+	TankId id = aiTanks[slot];
+	Tank& t = GetTank(id);
+	unsigned char team = teams[id.index];
+	glm::vec3 p = t.getPosition();
+	glm::vec2 at(p.x, p.z);
+
+	unsigned int* enemies = sighted + i * UtilityScorer::CANDIDATES;
+	float distanceSq[UtilityScorer::CANDIDATES];
+	size_t seen = broadphase.nearest(at, AI_SIGHT_RADIUS, UtilityScorer::CANDIDATES, enemies, distanceSq, [&](const SpatialHash::Proxy& proxy) {
+		if (proxy.kind != KIND_TANK || teams[proxy.index] == team || tanks[proxy.index].getHealth() <= 0)
+			return -1.0f;
+		glm::vec3 d = tanks[proxy.index].getPosition() - p;
+		return d.x*d.x + d.z*d.z;
+	});
+	// allies in weapon range of it, which only count against enemies
+	int allies = 0;
+	glm::vec2 reach(MAX_ATTACK_DISTANCE);
+	if (seen > 0) {
+		broadphase.query(at - reach, at + reach, [&](const SpatialHash::Proxy& proxy) {
+			if (proxy.kind != KIND_TANK || proxy.index == id.index || teams[proxy.index] != team || tanks[proxy.index].getHealth() <= 0)
+				return false;
+			glm::vec3 d = tanks[proxy.index].getPosition() - p;
+			if (d.x*d.x + d.z*d.z < MAX_ATTACK_DISTANCE * MAX_ATTACK_DISTANCE)
+				allies++;
+			return false;
+		});
+	}
+
+	tactics.sense(i, (float)t.getHealth() / AI_FULL_HEALTH, t.isLoaded(), allies);
+	for (size_t c = 0; c < seen; c++) {
+		Tank& enemy = tanks[enemies[c]];
+		glm::vec3 back = p - enemy.getPosition();
+		float distance = std::sqrt(distanceSq[c]);
+		// a turret points along (sin, -cos) of its right angle
+		float rightSin, rightCos;
+		sincosDegFast(enemy.getRightOrientation(), rightSin, rightCos);
+		float threat = distance > 0 ? (rightSin*back.x - rightCos*back.z) / distance : 1;
+		tactics.candidate(i, (int)c, distance / MAX_ATTACK_DISTANCE, (float)enemy.getHealth() / AI_FULL_HEALTH, threat);
+	}
+}
+// turn and throttle that take `t` along `dir`, front or back first, whichever is nearer to
+// facing it; the body faces (-yawSin, -yawCos)
+static void Steer(Tank& t, glm::vec2 dir, AIOrder& order) {
+	float ahead = -t.getYawSin()*dir.x - t.getYawCos()*dir.y;
+	float left = -t.getYawCos()*dir.x + t.getYawSin()*dir.y;
+	order.throttle = ahead >= 0 ? 1.0f : -1.0f;
+	if (ahead < 0)
+		left = -left;
+	order.turn = std::abs(left) <= AI_TURN_SIN * glm::length(dir) ? 0 : left > 0 ? TURN_RATE : -TURN_RATE;
+}
+/*
+Acts on what `tactics` picked for AI slot `slot`, the `i`-th tank thinking this tick: decides
+where it drives until it next thinks, and when that is, and files its shot at its target as
+`gunnery` pair `i`. With no enemy in sight its target is the player, whom it goes after when
+on another team and follows otherwise. Only reads the world and writes its own slot and pair,
+so any number of tanks think in parallel.
+*/
+void World::AIThink(unsigned int slot, size_t i, const unsigned int* sighted) {
+	TankId id = aiTanks[slot];
+	Tank& t = GetTank(id);
+	AIOrder& order = ai.orders[slot];
+	AIAction action = tactics.action(i);
+	int candidate = tactics.target(i);
+	TankId targetId = candidate >= 0 ? TankId(sighted[i * UtilityScorer::CANDIDATES + candidate]) : player;
+	bool hostile = teams[targetId.index] != teams[id.index];
+	Tank& target = GetTank(targetId);
+	glm::vec3 toTarget = target.getPosition() - t.getPosition();
+	glm::vec2 way(toTarget.x, toTarget.z);
+	float distanceSq = glm::dot(way, way);
+
+	// the chase field leads to the player around the crates; to anyone else it drives straight
+	glm::vec2 approach = way;
+	glm::vec2 flow;
+	if (targetId == player && chase.direction(nav.cellAt(glm::vec2(t.getPosition().x, t.getPosition().z)), flow))
+		approach = flow;
+	// fights closer while ahead on health and further off while behind
+	float minDistance = 30 + (target.getHealth() - t.getHealth())* 0.5;
+	bool closing = minDistance < 0 || distanceSq > minDistance*minDistance;
+	order.turn = 0;
+	order.throttle = 0;
+	switch (action) {
+	case AI_ENGAGE:
+		if (closing)
+			Steer(t, approach, order);
+		break;
+	case AI_FLANK: {
+		// circles the target, odd slots one way and even ones the other, drifting towards its
+		// fighting distance
+		glm::vec2 around = (slot & 1) ? glm::vec2(way.y, -way.x) : glm::vec2(-way.y, way.x);
+		Steer(t, around + way * (closing ? 0.3f : -0.3f), order);
+		break;
+	}
+	case AI_RETREAT:
+		Steer(t, -way, order);
+		break;
+	default:
+		if (hostile || distanceSq > AI_ESCORT_DISTANCE * AI_ESCORT_DISTANCE)
+			Steer(t, approach, order);
+		break;
+	}
+	order.action = (unsigned char)action;
+
+	// shells leave 3 units out along the barrel, which over that distance barely bends from a
+	// shot fired at the pivot, so the solver aims from the pivot; the target's last drive is
+	// its lead
+	gunnery.aim(i, t.getTurretPosition(), target.getPosition(), target.getVelocity());
+	order.fire = hostile && distanceSq < MAX_ATTACK_DISTANCE * MAX_ATTACK_DISTANCE;
+
+	AILod level = AI_LOD_FAR;
+	if (ai.inCombat(slot, tick) || (hostile && distanceSq < AI_COMBAT_RADIUS * AI_COMBAT_RADIUS))
+		level = AI_LOD_COMBAT;
+	else if (hostile && distanceSq < AI_NEAR_RADIUS * AI_NEAR_RADIUS)
+		level = AI_LOD_NEAR;
+	ai.thought(slot, tick, level);
+}
+// turns the turret of AI slot `slot` towards the low-arc solution of `gunnery` pair `shot`
+void World::AIAim(unsigned int slot, size_t shot) {
+	Tank& t = GetTank(aiTanks[slot]);
+	AIOrder& order = ai.orders[slot];
+	// the short way round from where the turret points now
+	order.aimRight = t.getRightOrientation() + std::remainder(gunnery.yaw(shot) - t.getRightOrientation(), 360.0f);
+	order.aimUp = -gunnery.lowElevation(shot);
+	order.fire = order.fire && gunnery.reachable(shot);
+}
+// `from` moved towards `to` by at most `step`
+static float StepTowards(float from, float to, float step) {
+	if (std::abs(to - from) <= step)
+		return to;
+	return to > from ? from + step : from - step;
+}
+// carries out the last orders of AI slot `slot` for one tick; changes the world, so tanks drive one at a time
+void World::AIDrive(unsigned int slot) {
+	TankId id = aiTanks[slot];
+	Tank& t = GetTank(id);
+	const AIOrder& order = ai.orders[slot];
+	glm::vec3 from = t.getPosition();
+
+	t.rotateBody(order.turn);
+	if (order.throttle > 0)
+		t.move(MOVEMENT_RATE);
+	else if (order.throttle < 0)
+		t.moveBack(MOVEMENT_RATE);
+	ResolvePenetration(id);
+	t.setVelocity((t.getPosition() - from) / tickSeconds);
+
+	t.moveTurret(StepTowards(t.getUpOrientation(), order.aimUp, TURRET_VERTICAL_RATE),
+		StepTowards(t.getRightOrientation(), order.aimRight, TURRET_HORIZONTAL_RATE));
+	// holds fire until the turret is on the solution
+	bool onTarget = t.getUpOrientation() == order.aimUp && t.getRightOrientation() == order.aimRight;
+	if (order.fire && onTarget && Fire(id))
+		ai.alert(slot, tick, AI_COMBAT_TICKS);
+}
+// fires a shell from the muzzle of `t` along its turret angles
+void World::SpawnProjectile(Tank& t) {
+	glm::vec3 turret = t.getTurretPosition();
+	float upSin, upCos, rightSin, rightCos;
+	sincosDeg(-t.getUpOrientation(), upSin, upCos);
+	sincosDeg(t.getRightOrientation(), rightSin, rightCos);
+	Projectile shot(turret.x + 3 * upCos*rightSin, turret.y + 3 * upSin, turret.z - 3 * upCos*rightCos, t.getRightOrientation(), t.getUpOrientation());
+	ProjectileHandle handle = projectilePool.acquire(shot);
+	if (!handle.valid())
+		return;
+	shells.create(assets.shell, glm::vec3(shot.getX(), shot.getY(), shot.getZ()), glm::vec3(0.1f, 0.1f, 0.1f));
+	projectiles.push_back(handle);
+
+	// the ground and the crates never move, so where the shell ends up is known now
+	Trajectory path = shot.trajectory(GRAVITY, PROJECTILE_SPEED);
+	float flight = path.descendingTo(SHELL_FLOOR);
+	float crate = FirstObstacleHit(path, flight);
+	if (crate >= 0)
+		flight = crate;
+	// the shell is gone on the tick whose move would carry it past `flight`
+	unsigned int firstMove = shellsMoved ? tick + 1 : tick;
+	int moves = (int)std::ceil(flight / tickSeconds) - 1;
+	timers.schedule(firstMove + (unsigned int)std::max(moves, 0), TIMER_IMPACT, (unsigned int)handle.generation << 16 | handle.index);
+}
+float World::FirstObstacleHit(const Trajectory& path, float tEnd) {
+	glm::vec3 end = path.at(tEnd);
+	float best = -1;
+	broadphase.traverse(glm::vec2(path.origin.x, path.origin.z), glm::vec2(end.x, end.z), [&](const SpatialHash::Proxy& p, float entry) {
+		// cells are walked in flight order, so nothing past the best hit can beat it
+		if (best >= 0 && entry * tEnd > best)
+			return true;
+		if (p.kind != KIND_OBSTACLE)
+			return false;
+		float t = path.enters(packObb(obstacles, p.index), tEnd);
+		if (t >= 0 && (best < 0 || t < best))
+			best = t;
+		return false;
+	});
+	return best;
+}
+// removes a shell from the pool and the live lists in O(1), filling its spot with the last live shell
+void World::DespawnProjectile(ProjectileHandle handle) {
+	if (!projectilePool.alive(handle))
+		return;
+	unsigned short index = projectilePool.denseIndex(handle);
+	EntityId last = shells.swapRemove(index);
+	if (index != last) {
+		projectiles[index] = projectiles[last];
+		projectilePool.setDenseIndex(projectiles[index], index);
+	}
+	projectiles.pop_back();
+	projectilePool.release(handle);
+}
+// flies shell `i` one tick and returns the tank it hit, if any; shells do not touch each other,
+// so any number of them can move in parallel
+TankId World::MoveShell(size_t i, float secondsEllapsed) {
+	Projectile* projectile = projectilePool.get(projectiles[i]);
+	projectile->move(secondsEllapsed, GRAVITY, PROJECTILE_SPEED);
+	glm::vec3 from = shells.position[i];
+	glm::vec3 to(projectile->getX(), projectile->getY(), projectile->getZ());
+	shells.position[i] = to;
+	shells.transform[i] = translate(to.x, to.y, to.z)*scale(0.1f, 0.1f, 0.1f);
+	return TankHitBy(from, to);
+}
+// applies the hits found by MoveShell, always in the same order no matter who found them
+void World::LandShells(TankId* hits) {
+	size_t i = 0;
+	while (i < projectiles.size()) {
+		if (hits[i].valid()) {
+			Damage(hits[i], 20);
+			// the last shell now sits at `i`, and so does its hit
+			hits[i] = hits[projectiles.size() - 1];
+			DespawnProjectile(projectiles[i]);
+		}
+		else {
+			i++;
+		}
+	}
+}
+// the tank a shell touched on its way from `from` to `to`, looking only at tanks whose
+// broadphase cells are in reach of that segment
+TankId World::TankHitBy(glm::vec3 from, glm::vec3 to) {
+	if (std::min(from.y, to.y) > TANK_HIT_CEILING)
+		return TankId();
+	glm::vec2 lo(std::min(from.x, to.x), std::min(from.z, to.z));
+	glm::vec2 hi(std::max(from.x, to.x), std::max(from.z, to.z));
+	TankId hit;
+	broadphase.query(lo - glm::vec2(TANK_HIT_REACH), hi + glm::vec2(TANK_HIT_REACH), [&](const SpatialHash::Proxy& proxy) {
+		if (proxy.kind == KIND_TANK && ProjectileCollide(tanks[proxy.index], from, to))
+			hit = TankId(proxy.index);
+		return hit.valid();
+	});
+	return hit;
+}
+void World::Damage(TankId id, double amount) {
+	Tank& t = GetTank(id);
+	bool alive = t.getHealth() > 0;
+	t.removeHealth(amount);
+	if (amount > 0 && aiSlots[id.index] != NO_AI_SLOT)
+		ai.alert(aiSlots[id.index], tick, AI_COMBAT_TICKS);
+	if (!alive || t.getHealth() > 0)
+		return;
+	if (id == player) {
+		terminated = true;
+	}
+	else if (respawnCount > 0) {
+		if (teams[id.index] != teams[player.index])
+			score += 100;
+		respawnCount--;
+		timers.schedule(tick + RESPAWN_TICKS, TIMER_RESPAWN, id.index);
+	}
+	else {
+		terminated = true;
+	}
+}
+bool World::Fire(TankId id) {
+	Tank& t = GetTank(id);
+	if (!t.shoot())
+		return false;
+	SpawnProjectile(t);
+	ScheduleReload(id);
+	return true;
+}
+void World::ScheduleReload(TankId id) {
+	reloadDue[id.index] = tick + RELOAD_TICKS;
+	timers.schedule(reloadDue[id.index], TIMER_RELOAD, id.index);
+}
+void World::OnTimer(const TimerWheel::Timer& timer) {
+	switch (timer.kind) {
+	case TIMER_RELOAD:
+		// a respawn since then started a newer reload, which is the one that counts
+		if (reloadDue[timer.target] == timer.due)
+			tanks[timer.target].reload();
+		break;
+	case TIMER_RESPAWN: {
+		TankId id(timer.target);
+		glm::vec3 spot = respawnPoints[id.index];
+		GetTank(id).respawn(spot.x, spot.y, spot.z, 0);
+		SyncTank(id);
+		ScheduleReload(id);
+		break;
+	}
+	case TIMER_IMPACT:
+		// stale when the shell already hit a tank
+		DespawnProjectile(ProjectileHandle(timer.target & 0xFFFF, timer.target >> 16));
+		break;
+	}
+}
+void World::SyncTank(TankId id) {
+	Tank& t = GetTank(id);
+	t.calculateCollisionVectors();
+	glm::vec2 lo, hi;
+	boundsXZ(tankParts, t.GetBody(), lo, hi);
+	broadphase.update(tankProxies[id.index], lo, hi);
+}
+// true when the body of the tank overlaps any crate or any other tank sharing a broadphase cell
+bool World::isBlocked(TankId id) {
+	SyncTank(id);
+	EntityId body = GetTank(id).GetBody();
+	Obb box = packObb(tankParts, body);
+	glm::vec2 lo, hi;
+	boundsXZ(tankParts, body, lo, hi);
+	// candidates that survive the distance bound and their cached axis are tested a full batch at a time
+	ObbBatch batch;
+	unsigned int pairs[ObbBatch::WIDTH];
+	bool blocked = broadphase.query(lo, hi, [&](const SpatialHash::Proxy& p) {
+		if (p.kind == KIND_TANK && p.index == id.index)
+			return false;
+		Obb other = p.kind == KIND_OBSTACLE ? packObb(obstacles, p.index) : packObb(tankParts, tanks[p.index].GetBody());
+		if (clearlyApart(box, other))
+			return false;
+		unsigned int pair = p.kind == KIND_OBSTACLE ? (p.index | OBSTACLE_PAIR_BIT) : p.index;
+		unsigned char axis = separatingAxes.get(id.index, pair);
+		if (axis != AxisCache::NONE && separatedOn(box, other, axis))
+			return false;
+		pairs[batch.count] = pair;
+		batch.add(other);
+		return batch.full() && FlushBatch(id, box, batch, pairs);
+	});
+	return blocked || FlushBatch(id, box, batch, pairs);
+}
+// pushes the tank out of every crate and tank it overlaps, each along its axis of least
+// penetration in the ground plane
+void World::ResolvePenetration(TankId id) {
+	Tank& t = GetTank(id);
+	if (!isBlocked(id))
+		return;
+	EntityId body = t.GetBody();
+	glm::vec2 lo, hi;
+	boundsXZ(tankParts, body, lo, hi);
+	// the proxy only moves in SyncTank, so pushing the tank while walking its cells is safe;
+	// gathering the candidates first would need room for every proxy in the world
+	broadphase.query(lo, hi, [&](const SpatialHash::Proxy& p) {
+		if (p.kind == KIND_TANK && p.index == id.index)
+			return false;
+		Obb other = p.kind == KIND_OBSTACLE ? packObb(obstacles, p.index) : packObb(tankParts, tanks[p.index].GetBody());
+		Contact contact;
+		if (penetration(packObb(tankParts, body), other, contact, true)) {
+			t.translateBy(glm::vec3(contact.normal.x, 0, contact.normal.z) * (contact.depth + CONTACT_SKIN));
+			t.calculateCollisionVectors();
+		}
+		return false;
+	});
+	SyncTank(id);
+}
+// runs the batched test and remembers which axis separated each pair
+bool World::FlushBatch(TankId id, const Obb& box, ObbBatch& batch, const unsigned int* pairs) {
+	unsigned char axes[ObbBatch::WIDTH];
+	unsigned int hits = overlapMask(box, batch, axes);
+	for (int lane = 0; lane < batch.count; lane++)
+		separatingAxes.set(id.index, pairs[lane], ((hits >> lane) & 1) ? AxisCache::NONE : axes[lane]);
+	batch.clear();
+	return hits != 0;
+}
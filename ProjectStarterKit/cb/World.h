@@ -0,0 +1,146 @@
+#ifndef WORLD_H
+#define WORLD_H
+#include "Simulation.h"
+#include "Arena.h"
+#include "EntityStore.h"
+#include "Tank.h"
+#include "Projectile.h"
+#include "ProjectilePool.h"
+#include "Registry.h"
+#include "SpatialHash.h"
+#include "ObbBatch.h"
+#include "AxisCache.h"
+#include "TimerWheel.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
+#include "AIScheduler.h"
+#include "NavGrid.h"
+#include "FiringSolver.h"
+#include "UtilityScorer.h"
+#include <vector>
+
+namespace cb {
+
+	// aiSlots entry of a tank the player drives
+	const unsigned int NO_AI_SLOT = 0xFFFFFFFF;
+	// team of the player; AddTank puts the stock AI tanks on ENEMY_TEAM
+	const unsigned char PLAYER_TEAM = 0;
+	const unsigned char ENEMY_TEAM = 1;
+
+	/*
+	Delayed events of a match, as filed in its timer wheel
+	*/
+	enum TimerKind {
+		TIMER_RELOAD,	// target: tank index
+		TIMER_RESPAWN,	// target: tank index
+		TIMER_IMPACT	// target: shell handle, generation << 16 | index
+	};
+
+	/*
+	One match
+
+	Owns every piece of match state, so a process can hold as many matches as it likes. When
+	given an arena, all entity pools are carved out of it and reserved up front, keeping a
+	world's memory together and away from other worlds.
+
+	The world is also the registry of its entities: `AddObstacle` and `AddTank` hand out typed
+	ids that stay valid for the whole match, and each kind lives in its own dense range
+	(`obstacles`, `tanks`, `projectiles`) that systems iterate directly.
+	*/
+	class World {
+	public:
+		World(Arena* arena = NULL);
+
+		//create all the entities for the 3D scene and add them to their pools
+		void CreateInstances(const MatchAssets& matchAssets);
+		// adds a static crate
+		ObstacleId AddObstacle(float x, float y, float z);
+		// adds a tank of `team` that comes back at `respawn` when it dies; `ai` puts it under AI control
+		TankId AddTank(glm::vec3 spawn, float xz, glm::vec3 respawn, bool ai, unsigned char team);
+		Tank& GetTank(TankId id) { return tanks[id.index]; }
+		Tank& GetPlayer() { return tanks[player.index]; }
+		size_t tankCount() const { return tanks.size(); }
+		// advances the whole match by one fixed tick
+		void SimulationTick(float tickSeconds, const TankControls& controls, bool aiEnabled);
+
+		// applies `amount` damage (negative heals) and handles the tank going down
+		void Damage(TankId id, double amount);
+		// shoots if the tank is loaded and starts its reload
+		bool Fire(TankId id);
+		bool isBlocked(TankId id);
+		void ResolvePenetration(TankId id);
+		void SpawnProjectile(Tank& t);
+		void DespawnProjectile(ProjectileHandle handle);
+
+		bool terminated;
+		unsigned int tick;	// simulation ticks run so far
+		int respawnCount;
+		double score;
+
+		// dense pools for the ground, the static crates, the tank parts and the live shells
+		EntityStore scenery;
+		EntityStore obstacles;
+		EntityStore tankParts;
+		EntityStore shells;
+		// tanks[i] is TankId(i); respawnPoints and teams are parallel to it
+		Column<Tank> tanks;
+		Column<glm::vec3> respawnPoints;
+		Column<unsigned char> teams;	// tanks of another team are enemies
+		// aiTanks[slot] is the tank of AI slot `slot`; aiSlots[i] is the slot of TankId(i), or NO_AI_SLOT
+		Column<TankId> aiTanks;
+		Column<unsigned int> aiSlots;
+		AIScheduler ai;
+		// where tanks can drive, and the way to the player from every cell of it
+		NavGrid nav;
+		FlowField chase;
+		// what the AI tanks thinking this tick make of the enemies near them, and their firing
+		// solutions, both in the order they think in
+		UtilityScorer tactics;
+		FiringSolver gunnery;
+		TankId player;
+		// XZ broadphase over crates and tank bodies; tankProxies[i] belongs to TankId(i)
+		SpatialHash broadphase;
+		Column<unsigned int> tankProxies;
+		// last separating axis of each (tank, crate or tank) pair
+		AxisCache separatingAxes;
+		ProjectilePool projectilePool;
+		Column<ProjectileHandle> projectiles; // projectiles[i] is drawn by shells slot i
+		// reloads, respawns and shell impacts, all counted in simulation ticks
+		TimerWheel timers;
+		Column<unsigned int> reloadDue;	// tick each tank's pending reload completes on
+		MatchAssets assets;
+		// scratch memory for query results and the like, cleared at the start of every tick
+		FrameArena tickScratch;
+		// runs the parallel part of each tick; with none it all runs on the calling thread
+		JobSystem* jobs;
+
+	private:
+		void UpdatePlayer(const TankControls& controls);
+		// moves the broadphase proxy of a tank to where its body is now
+		void SyncTank(TankId id);
+		void UpdateTransforms();
+		// flight time at which `path` first enters a crate before `tEnd`, or -1
+		float FirstObstacleHit(const Trajectory& path, float tEnd);
+		TankId TankHitBy(glm::vec3 from, glm::vec3 to);
+		void ScheduleReload(TankId id);
+		void OnTimer(const TimerWheel::Timer& timer);
+		bool FlushBatch(TankId id, const Obb& box, ObbBatch& batch, const unsigned int* pairs);
+
+		void AISense(unsigned int slot, size_t i, unsigned int* sighted);
+		void AIThink(unsigned int slot, size_t i, const unsigned int* sighted);
+		void AIAim(unsigned int slot, size_t shot);
+		void AIDrive(unsigned int slot);
+		TankId MoveShell(size_t i, float secondsEllapsed);
+		void LandShells(TankId* hits);
+
+		float tickSeconds;
+		bool shellsMoved;	// shells already moved this tick
+		TaskGraph tickGraph;
+
+		//worlds own arena-backed pools and are only ever placed, not copied
+		World(const World&);
+		const World& operator=(const World&);
+	};
+
+}
+#endif
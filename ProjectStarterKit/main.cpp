@@ -38,11 +38,12 @@ limitations under the License.
 #include "cb/Texture.h"
 #include "cb/Camera.h"
 #include "cb/Structures.h"
-#include "cb/Tank.h"
 #include "cb/Sphere.hpp"
-#include "cb/Projectile.h"
-
-# define PI          3.141592653589793238462643383279502884L
+#include "cb/SimClock.h"
+#include "cb/World.h"
+#include "cb/AllocCounter.h"
+#include "cb/FrameArena.h"
+#include "cb/JobSystem.h"
 
 /*
 Represents a textured geometry asset
@@ -60,48 +61,27 @@ using namespace cb;
 
 // constants
 const glm::vec2 SCREEN_SIZE(1366, 768);
-
-const GLfloat TURN_RATE = 0.07;
-const GLfloat MOVEMENT_RATE = 0.03;
-const GLfloat MAX_ATTACK_DISTANCE = 40;
-const GLfloat PROJECTILE_SPEED = 30;
-const GLfloat GRAVITY = 1;
-const GLfloat TURRET_HORIZONTAL_RATE = 0.1f;
-const GLfloat TURRET_VERTICAL_RATE = 0.1f;
-const int OBSTACLE_START_INDEX = 10;
-const int OBSTACLE_END_INDEX = 13;
-bool terminated = false;
-int respawnCount = 5;
-double score = 0;
+const int MAX_TICKS_PER_FRAME = 8;
+const size_t FRAME_ARENA_BYTES = 1 << 20;
 
 // globals
 GLFWwindow* gWindow = NULL;
+cb::World gWorld;
+cb::SimClock gClock(TICK_SECONDS, MAX_TICKS_PER_FRAME);
+cb::DoubleFrameArena gFrames(FRAME_ARENA_BYTES);
 double gScrollY = 0.0;
 cb::Camera gCamera;
 cb::ModelAsset gTank;
 cb::ModelAsset gTerrain;
 cb::ModelAsset gBall;
-std::vector<ModelInstance*> gInstances;
 GLfloat gForward = 0.0f;
 std::vector<cb::Light> gLights;
+std::vector<cb::LightUniforms> gLightUniforms;
 GLfloat mRight = 0.0f;
 GLfloat mUp = 0.0f;
 GLfloat camx;
 GLfloat camy;
 GLfloat camz;
-ModelInstance terrain, tank1, tank2, tank3;
-Tank pTank, eTank, eTank2;
-Projectile p,p2;
-std::vector<Projectile*> projectiles;
-
-void AIMove(Tank& tank);
-void ProjectileMove(float t);
-bool ProjectileCollide(Tank & t, Projectile* projectile);
-GLfloat distance(GLfloat x, GLfloat y, GLfloat z, GLfloat px, GLfloat py, GLfloat pz);
-void checkHealth(Tank& t);
-bool OBB(ModelInstance a, ModelInstance b, glm::vec3 L);
-bool isColliding(ModelInstance obstacle, ModelInstance moving);
-
 
 // returns a new cb::Program created from the given vertex and fragment shader filenames
 static cb::Program* LoadShaders(const char* vertFilename, const char* fragFilename) {
@@ -283,7 +263,9 @@ void LoadBallAsset(int depth, ModelAsset & gBall) {
 
 	Sphere sphere(glm::vec4(), glm::vec3(0, 0, 0), 1.0f);
 
-	GLfloat* vertexDataPointer = sphere.render(depth);
+	// the vertex data is only needed until it is uploaded
+	FrameArena scratch(Sphere::scratchBytes(depth));
+	GLfloat* vertexDataPointer = sphere.render(depth, scratch);
 
 
 
@@ -324,89 +306,27 @@ void LoadBallAsset(int depth, ModelAsset & gBall) {
 
 
 
-//create all the `instance` structs for the 3D scene, and add them to `gInstances`
-static void CreateInstances() {
-	/*ModelInstance dot;
-	dot.asset = &gTank;
-	dot.transform = glm::mat4();
-	gInstances.push_back(dot);*/
-
-
-	terrain.asset = &gTerrain;
-	terrain.transform = translate(-1024, 0, -1024)*scale(2048, 0, 2048);
-	gInstances.push_back(&terrain);
-	
-
-
-	pTank = Tank(0, 0.5, 0, gTank, gTerrain, gTank, 0);
-
-	eTank = Tank(0, 0.5, -120, gTank, gTerrain, gTank, 0);
-	eTank2 = Tank(0, 0.5, 120, gTank, gTerrain, gTank, 0);
-
-	//p = Projectile(0, 0.5, -1, gBall, 0, 0);
-	//p2 = Projectile(0, 0.5, 1, gBall, 0, 0);
-
-	gInstances.push_back(pTank.GetBody());
-	gInstances.push_back(eTank.GetBody());
-	gInstances.push_back(eTank2.GetBody());
-
-	gInstances.push_back(pTank.GetTurret());
-	gInstances.push_back(pTank.GetCannon());
-	
-	gInstances.push_back(eTank.GetTurret());
-	gInstances.push_back(eTank.GetCannon());
-
-	gInstances.push_back(eTank2.GetTurret());
-	gInstances.push_back(eTank2.GetCannon());
-
-	eTank.moveTurret(-10, 0);
-
-	tank1.asset = &gTank;
-	tank1.transform = translate(-5, 1, -10)*scale(1, 1, 1);
-	tank1.positionX = -5;
-	tank1.positionY = 1;
-	tank1.positionZ = -10;
-	tank1.setSize(1, 1, 1);
-	tank1.setColllisionVectors(getTransformArray(tank1));
-	gInstances.push_back(&tank1);
-
-
-	tank2.asset = &gTank;
-	tank2.transform = translate(5, 1, -10)*scale(1, 1, 1);
-	tank2.positionX = 5;
-	tank2.positionY = 1;
-	tank2.positionZ = -10;
-	tank2.setSize(1, 1, 1);
-	tank2.setColllisionVectors(getTransformArray(tank2));
-	gInstances.push_back(&tank2);
-
-	tank3.asset = &gTank;
-	tank3.transform = translate(0, 1, -10)*scale(1, 1, 1);
-	tank3.positionX = 5;
-	tank3.positionY = 1;
-	tank3.positionZ = -10;
-	tank3.setSize(1, 1, 1);
-	tank3.setColllisionVectors(getTransformArray(tank3));
-	gInstances.push_back(&tank3);
-
-	//gInstances.push_back(p.getBody());
-	//gInstances.push_back(p2.getBody());
-
-
-}
-
-template <typename T>
-void SetLightUniform(cb::Program* shaders, const char* propertyName, size_t lightIndex, const T& value) {
+static std::string LightUniformName(size_t lightIndex, const char* propertyName) {
 	std::ostringstream ss;
 	ss << "allLights[" << lightIndex << "]." << propertyName;
-	std::string uniformName = ss.str();
+	return ss.str();
+}
 
-	shaders->setUniform(uniformName.c_str(), value);
+// builds the uniform names of every light once, so drawing does not format strings
+static void CacheLightUniforms() {
+	gLightUniforms.resize(gLights.size());
+	for (size_t i = 0; i < gLights.size(); ++i) {
+		gLightUniforms[i].position = LightUniformName(i, "position");
+		gLightUniforms[i].intensities = LightUniformName(i, "intensities");
+		gLightUniforms[i].attenuation = LightUniformName(i, "attenuation");
+		gLightUniforms[i].ambientCoefficient = LightUniformName(i, "ambientCoefficient");
+		gLightUniforms[i].coneAngle = LightUniformName(i, "coneAngle");
+		gLightUniforms[i].coneDirection = LightUniformName(i, "coneDirection");
+	}
 }
 
-//renders a single `ModelInstance`
-static void RenderInstance(ModelInstance* inst) {
-	cb::ModelAsset* asset = inst->asset;
+//renders a single entity
+static void RenderInstance(cb::ModelAsset* asset, const glm::mat4& transform) {
 	cb::Program* shaders = asset->shaders;
 
 	//bind the shaders
@@ -414,7 +334,7 @@ static void RenderInstance(ModelInstance* inst) {
 
 	//set the shader uniforms
 	shaders->setUniform("camera", gCamera.matrix());
-	shaders->setUniform("model", inst->transform);
+	shaders->setUniform("model", transform);
 	shaders->setUniform("materialTex", 0); //set to 0 because the texture will be bound to GL_TEXTURE0
 	shaders->setUniform("materialShininess", asset->shininess);
 	shaders->setUniform("materialSpecularColor", asset->specularColor);
@@ -422,12 +342,13 @@ static void RenderInstance(ModelInstance* inst) {
 	shaders->setUniform("numLights", (int)gLights.size());
 
 	for (size_t i = 0; i < gLights.size(); ++i) {
-		SetLightUniform(shaders, "position", i, gLights[i].position);
-		SetLightUniform(shaders, "intensities", i, gLights[i].intensities);
-		SetLightUniform(shaders, "attenuation", i, gLights[i].attenuation);
-		SetLightUniform(shaders, "ambientCoefficient", i, gLights[i].ambientCoefficient);
-		SetLightUniform(shaders, "coneAngle", i, gLights[i].coneAngle);
-		SetLightUniform(shaders, "coneDirection", i, gLights[i].coneDirection);
+		const LightUniforms& names = gLightUniforms[i];
+		shaders->setUniform(names.position.c_str(), gLights[i].position);
+		shaders->setUniform(names.intensities.c_str(), gLights[i].intensities);
+		shaders->setUniform(names.attenuation.c_str(), gLights[i].attenuation);
+		shaders->setUniform(names.ambientCoefficient.c_str(), gLights[i].ambientCoefficient);
+		shaders->setUniform(names.coneAngle.c_str(), gLights[i].coneAngle);
+		shaders->setUniform(names.coneDirection.c_str(), gLights[i].coneDirection);
 	}
 
 	//bind the texture
@@ -445,121 +366,75 @@ static void RenderInstance(ModelInstance* inst) {
 }
 
 
+// one instance to draw this frame
+struct DrawItem {
+	cb::ModelAsset* asset;
+	glm::mat4 transform;
+};
+
+//queues every entity of a pool in order, `alpha` of the way from the previous tick to the current one
+static void CollectStore(const EntityStore& store, float alpha, ScratchList<DrawItem>& draws) {
+	for (size_t i = 0; i < store.count(); i++) {
+		DrawItem item = { store.asset[i], store.interpolated(i, alpha) };
+		draws.push_back(item);
+	}
+}
+
 // draws a single frame
-static void Render() {
+static void Render(float alpha) {
 	// clear everything
 	glClearColor(0.4, 0.4, 0.6, 1); // black
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	// render all the instances
-	for (int i = 0; i < gInstances.size(); i++) {
-		RenderInstance(gInstances[i]);
+	// build this frame's draw list in scratch memory, then render all the instances
+	size_t instances = gWorld.scenery.count() + gWorld.tankParts.count() + gWorld.obstacles.count() + gWorld.shells.count();
+	ScratchList<DrawItem> draws = gFrames.thisFrame().list<DrawItem>(instances);
+	CollectStore(gWorld.scenery, alpha, draws);
+	CollectStore(gWorld.tankParts, alpha, draws);
+	CollectStore(gWorld.obstacles, alpha, draws);
+	CollectStore(gWorld.shells, alpha, draws);
+	for (size_t i = 0; i < draws.size(); i++) {
+		RenderInstance(draws[i].asset, draws[i].transform);
 	}
 
 	// swap the display buffers (displays what was just drawn)
 	glfwSwapBuffers(gWindow);
 }
 
-// update the scene based on the time elapsed since last update
-static void Update(float secondsElapsed) {
-	//rotate the first instance in `gInstances
-	const GLfloat degreesPerSecond = 180.0f;
+// reads the player's keys and aim for the next simulation tick
+static TankControls ReadControls() {
+	TankControls controls;
+	controls.back = glfwGetKey(gWindow, 'S') == GLFW_PRESS;
+	controls.forward = glfwGetKey(gWindow, 'W') == GLFW_PRESS;
+	controls.left = glfwGetKey(gWindow, 'A') == GLFW_PRESS;
+	controls.right = glfwGetKey(gWindow, 'D') == GLFW_PRESS;
+	controls.damageEnemy = glfwGetKey(gWindow, 'I') == GLFW_PRESS;
+	controls.healEnemy = glfwGetKey(gWindow, 'J') == GLFW_PRESS;
+	controls.fire = glfwGetKey(gWindow, 'K') == GLFW_PRESS;
+	controls.aimUp = mUp;
+	controls.aimRight = mRight;
+	return controls;
+}
 
-	camx = pTank.GetBody()->positionX - 5 * glm::sin(glm::radians(mRight));
-	camz = pTank.GetBody()->positionZ + 5 * glm::cos(glm::radians(mRight));
+// update the camera and the controls based on the time elapsed since last frame
+static void Update(float secondsElapsed, float alpha) {
+	glm::vec3 followed(gWorld.tankParts.interpolated(gWorld.GetPlayer().GetBody(), alpha)[3]);
+	camx = followed.x - 5 * glm::sin(glm::radians(mRight));
+	camz = followed.z + 5 * glm::cos(glm::radians(mRight));
 	camy = 2 + 2 * glm::sin(glm::radians(mUp));
 
 	gCamera.setPosition(glm::vec3(camx, camy, camz));
 	const float mouseSensitivity = 0.1f;
 	double mouseX, mouseY;
 
-	//move position of camera based on WASD keys, and XZ keys for up and down
+	//move position of camera with the XZ keys for up and down
 	const float moveSpeed = 4.0; //units per second
-	if (glfwGetKey(gWindow, 'S')) {
-		bool colliding = false;
-		pTank.moveBack(MOVEMENT_RATE);
-		pTank.calculateCollisionVectors();
-		for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-			if (isColliding(*gInstances[i], *gInstances[1]))
-				colliding = true;
-		}
-		if (isColliding(*gInstances[2], *gInstances[1]))
-			colliding = true;
-		if (isColliding(*gInstances[3], *gInstances[1]))
-			colliding = true;
-		if (colliding) {
-			pTank.move(MOVEMENT_RATE * 5);
-		}
-	}
-	else if (glfwGetKey(gWindow, 'W')) {
-		bool colliding = false;
-		pTank.move(MOVEMENT_RATE);
-		pTank.calculateCollisionVectors();
-		for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-			if (isColliding(*gInstances[i], *gInstances[1]))
-				colliding = true;
-		}
-		if (isColliding(*gInstances[2], *gInstances[1]))
-			colliding = true;
-		if (isColliding(*gInstances[3], *gInstances[1]))
-			colliding = true;
-		if (colliding) {
-			pTank.moveBack(MOVEMENT_RATE * 5);
-		}
-
-	}
-	if (glfwGetKey(gWindow, 'A')) {
-		bool colliding = false;
-		pTank.rotateBody(TURN_RATE);
-		pTank.calculateCollisionVectors();
-		for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-			if (isColliding(*gInstances[i], *gInstances[1]))
-				colliding = true;
-		}
-		if (isColliding(*gInstances[2], *gInstances[1]))
-			colliding = true;
-		if (isColliding(*gInstances[3], *gInstances[1]))
-			colliding = true;
-		if (colliding) {
-			pTank.rotateBody(-TURN_RATE);
-		}
-	}
-	else if (glfwGetKey(gWindow, 'D')) {
-		bool colliding = false;
-		pTank.rotateBody(-TURN_RATE);
-		pTank.calculateCollisionVectors();
-		for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-			if (isColliding(*gInstances[i], *gInstances[1]))
-				colliding = true;
-		}
-		if (isColliding(*gInstances[2], *gInstances[1]))
-			colliding = true;
-		if (isColliding(*gInstances[3], *gInstances[1]))
-			colliding = true;
-		if (colliding) {
-			pTank.rotateBody(+TURN_RATE);
-		}
-	}
 	if (glfwGetKey(gWindow, 'Z')) {
 		gCamera.offsetPosition(secondsElapsed * moveSpeed * -glm::vec3(0, 1, 0));
 	}
 	else if (glfwGetKey(gWindow, 'X')) {
 		gCamera.offsetPosition(secondsElapsed * moveSpeed * glm::vec3(0, 1, 0));
 	}
-	else if (glfwGetKey(gWindow, 'I')) {
-		eTank.removeHealth(100);
-	}
-	else if (glfwGetKey(gWindow, 'J')) {
-		eTank.removeHealth(-10);
-	}
-	else if (glfwGetKey(gWindow, 'K')) {
-		if (pTank.shoot()) {
-			Projectile* shot = new Projectile(pTank.GetTurret()->positionX + 3*glm::cos(glm::radians(-pTank.getUpOrientation()))*glm::sin(glm::radians(pTank.getRightOrientation())), pTank.GetTurret()->positionY + 3 * glm::sin(glm::radians(-pTank.getUpOrientation())), pTank.GetTurret()->positionZ- 3 * glm::cos(glm::radians(-pTank.getUpOrientation()))*glm::cos(glm::radians(pTank.getRightOrientation())), gBall, pTank.getRightOrientation(), pTank.getUpOrientation());
-			gInstances.push_back(shot->getBody());
-			projectiles.push_back(shot);
-			std::cout << eTank2.getHealth() << std::endl;
-		}
-	}
 
 	//move light
 	if (glfwGetKey(gWindow, '1')) {
@@ -578,7 +453,6 @@ static void Update(float secondsElapsed) {
 
 	 //rotate camera based on mouse movement
 	glfwGetCursorPos(gWindow, &mouseX, &mouseY);
-	pTank.moveTurret(mUp, mRight);
 	mRight = mRight + mouseSensitivity*(float)mouseX;
 	if (!(mUp > 10 && mouseY > 0 || mUp < -45 && mouseY < 0))
 	{
@@ -662,7 +536,12 @@ void AppMain() {
 	LoadBallAsset(6,gBall);
 
 	// create all the instances in the 3D scene based on the gWoodenCrate asset
-	CreateInstances();
+	MatchAssets assets;
+	assets.terrain = &gTerrain;
+	assets.tank = &gTank;
+	assets.turret = &gTerrain;
+	assets.shell = &gBall;
+	gWorld.CreateInstances(assets);
 
 	// setup gCamera
 	gCamera.setPosition(glm::vec3(0, 5, -14));
@@ -685,28 +564,38 @@ void AppMain() {
 
 	gLights.push_back(spotlight);
 	gLights.push_back(directionalLight);
+	CacheLightUniforms();
+
 
+	// the simulation spreads its per-tick work over every core
+	JobSystem jobs;
+	gWorld.jobs = &jobs;
 
 	// run while the window is open
 	double lastTime = glfwGetTime();
-	while (!glfwWindowShouldClose(gWindow) &&!terminated) {
+	AllocCounts sessionStart = allocationCounts();
+	unsigned long long frames = 0, allocatingFrames = 0;
+	while (!glfwWindowShouldClose(gWindow) &&!gWorld.terminated) {
+		AllocCounts frameStart = allocationCounts();
+		gFrames.beginFrame();
 		// process pending events
 		glfwPollEvents();
 
-		// update the scene based on the time elapsed since last update
+		// run as many fixed ticks as the time elapsed since last frame calls for
 		double thisTime = glfwGetTime();
-		Update((float)(thisTime - lastTime));
-		ProjectileMove((float)(thisTime - lastTime));
-		lastTime = thisTime;
-		checkHealth(pTank);
-		checkHealth(eTank);
-		checkHealth(eTank2);
-		
-		if (terminated) break;
-
-	//	AIMove(eTank);
-	//	AIMove(eTank2);
-		Render();
+		int ticks = gClock.advance(thisTime - lastTime);
+		TankControls controls = ReadControls();
+		for (int i = 0; i < ticks && !gWorld.terminated; i++) {
+			gWorld.SimulationTick((float)gClock.tickSeconds(), controls, true);
+		}
+		if (gWorld.terminated) break;
+
+		{
+			AllocPhaseScope phase(PHASE_RENDER);
+			Update((float)(thisTime - lastTime), gClock.alpha());
+			lastTime = thisTime;
+			Render(gClock.alpha());
+		}
 		// check for errors
 		GLenum error = glGetError();
 		if (error != GL_NO_ERROR)
@@ -715,456 +604,26 @@ void AppMain() {
 		//exit program if escape key is pressed
 		if (glfwGetKey(gWindow, GLFW_KEY_ESCAPE))
 			glfwSetWindowShouldClose(gWindow, GL_TRUE);
+
+		frames++;
+		if (allocationCounts().since(frameStart).total().allocations > 0)
+			allocatingFrames++;
 	}
+	std::cout << "heap allocations during play, " << allocatingFrames << " of " << frames << " frames allocated:" << std::endl;
+	reportAllocations(std::cout, allocationCounts().since(sessionStart));
 
 	// clean up and exit
+	gWorld.jobs = NULL;
 	glfwTerminate();
 }
-void AIMove(Tank& t) {
-
-	GLfloat angleDifference = abs(pTank.getXZOrientation() - eTank.getXZOrientation());
-	GLfloat distance = sqrt(pow(pTank.GetBody()->positionZ - t.GetBody()->positionZ, 2) + pow(pTank.GetBody()->positionX - t.GetBody()->positionX, 2));
-	GLfloat minDistance = 30 + (pTank.getHealth() - t.getHealth())* 0.5;
-	int tankIndex;
-	if (t.GetBody() == eTank.GetBody()) {
-		tankIndex = 2;
-	}
-	else {
-		tankIndex = 3;
-	}
-	if (distance > minDistance) {
-		if (abs(pTank.getXZOrientation() - eTank.getXZOrientation() - TURN_RATE) < angleDifference) {
-			bool colliding = false;
-			t.rotateBody(TURN_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.rotateBody(-TURN_RATE * 5);
-			}
-		}
-		else if (abs(pTank.getXZOrientation() - eTank.getXZOrientation() + TURN_RATE) < angleDifference) {
-			bool colliding = false;
-			t.rotateBody(-TURN_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.rotateBody(TURN_RATE * 5);
-			}
-		}
-		else {
-			bool colliding = false;
-			t.rotateBody(TURN_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.rotateBody(-TURN_RATE * 5);
-			}
-		}
-		if (distance > sqrt(pow(pTank.GetBody()->positionZ - t.GetBody()->positionZ + MOVEMENT_RATE*glm::cos(glm::radians(t.getXZOrientation())), 2) + pow(pTank.GetBody()->positionX - t.GetBody()->positionX - MOVEMENT_RATE*glm::sin(glm::radians(-t.getXZOrientation())), 2)))
-		{
-			bool colliding = false;
-			t.move(MOVEMENT_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.moveBack(MOVEMENT_RATE * 5);
-			}
-		}
-		else
-		{
-			bool colliding = false;
-			t.moveBack(MOVEMENT_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.move(MOVEMENT_RATE * 5);
-			}
-		}
-	}
-	else{
-		if (abs(pTank.getXZOrientation() - eTank.getXZOrientation() - TURN_RATE) < angleDifference) {
-			bool colliding = false;
-			t.rotateBody(-TURN_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.rotateBody(TURN_RATE * 5);
-			}
-		}
-		else if (abs(pTank.getXZOrientation() - eTank.getXZOrientation() + TURN_RATE) < angleDifference) {
-			bool colliding = false;
-			t.rotateBody(TURN_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.rotateBody(-TURN_RATE * 5);
-			}
-		}
-		else {
-			bool colliding = false;
-			t.rotateBody(TURN_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.rotateBody(-TURN_RATE * 5);
-			}
-		}
-		if (distance > sqrt(pow(pTank.GetBody()->positionZ - t.GetBody()->positionZ + MOVEMENT_RATE*glm::cos(glm::radians(t.getXZOrientation())), 2) + pow(pTank.GetBody()->positionX - t.GetBody()->positionX - MOVEMENT_RATE*glm::sin(glm::radians(-t.getXZOrientation())), 2)))
-		{
-			bool colliding = false;
-			t.moveBack(MOVEMENT_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.move(MOVEMENT_RATE * 5);
-			}
-		}
-		else
-		{
-			bool colliding = false;
-			t.move(MOVEMENT_RATE);
-			t.calculateCollisionVectors();
-			for (int i = OBSTACLE_START_INDEX; i < OBSTACLE_END_INDEX;i++) {
-				if (isColliding(*gInstances[i], *gInstances[tankIndex]))
-					colliding = true;
-			}
-			if (isColliding(*gInstances[1], *gInstances[tankIndex]))
-				colliding = true;
-			int friendlyTankIndex = (tankIndex == 3 ? 2 : 3);
-			if (isColliding(*gInstances[friendlyTankIndex], *gInstances[tankIndex]))
-				colliding = true;
-			if (colliding) {
-				t.moveBack(MOVEMENT_RATE * 5);
-			}
-		}
-	}
-
-	GLfloat aimDistance = sqrt(pow(pTank.GetBody()->positionZ - (t.GetTurret()->positionZ-glm::cos(glm::radians(t.getRightOrientation()))), 2) + pow(pTank.GetBody()->positionX - (t.GetTurret()->positionX + glm::sin(glm::radians(t.getRightOrientation()))), 2));
-	if (aimDistance > sqrt(pow(pTank.GetBody()->positionZ - (t.GetTurret()->positionZ - glm::cos(glm::radians(t.getRightOrientation() + TURRET_HORIZONTAL_RATE))), 2) + pow(pTank.GetBody()->positionX - (t.GetTurret()->positionX + glm::sin(glm::radians(t.getRightOrientation() + TURRET_HORIZONTAL_RATE))), 2))){
-		t.moveTurret(t.getUpOrientation(), t.getRightOrientation() + TURRET_HORIZONTAL_RATE);
-	}
-	else if(aimDistance < sqrt(pow(pTank.GetBody()->positionZ - (t.GetTurret()->positionZ - glm::cos(glm::radians(t.getRightOrientation() + TURRET_HORIZONTAL_RATE))), 2) + pow(pTank.GetBody()->positionX - (t.GetTurret()->positionX + glm::sin(glm::radians(t.getRightOrientation() + TURRET_HORIZONTAL_RATE))), 2))) {
-		t.moveTurret(t.getUpOrientation(), t.getRightOrientation() - TURRET_HORIZONTAL_RATE);
-	}
-
-	
-	float sin2theta = (distance*GRAVITY) / (PROJECTILE_SPEED * PROJECTILE_SPEED);
-	float theta2 = asin(sin2theta);
-	float angleToFire = ((theta2* 180.0f) / PI) / 2;
-	if (angleToFire != angleToFire)
-		angleToFire = t.getUpOrientation();
-	if (angleToFire > -1 * (t.getUpOrientation())) {
-		t.moveTurret(t.getUpOrientation() - TURRET_VERTICAL_RATE, t.getRightOrientation());
-	}
-	else if (angleToFire < -1 * (t.getUpOrientation())) {
-		t.moveTurret(t.getUpOrientation() + TURRET_VERTICAL_RATE, t.getRightOrientation());
-	}
-	
-	
-	
-	if (distance < MAX_ATTACK_DISTANCE) {
-		if (t.shoot()) {
-			Projectile* shot = new Projectile(t.GetTurret()->positionX + 3 * glm::cos(glm::radians(-t.getUpOrientation()))*glm::sin(glm::radians(t.getRightOrientation())), t.GetTurret()->positionY + 3 * glm::sin(glm::radians(-t.getUpOrientation())), t.GetTurret()->positionZ - 3 * glm::cos(glm::radians(-t.getUpOrientation()))*glm::cos(glm::radians(t.getRightOrientation())), gBall, t.getRightOrientation(), t.getUpOrientation());
-			gInstances.push_back(shot->getBody());
-			projectiles.push_back(shot);
-		}
-	}
-	
-}
-void ProjectileMove(float secondsEllapsed) {
-	for (int i = 0;i < projectiles.size();i++) {
-		projectiles[i]->move(secondsEllapsed, GRAVITY, PROJECTILE_SPEED);
-		if (projectiles[i]->getY() <= -1) {
-			for (int j = 0;j < gInstances.size();j++) {
-				if (projectiles[i]->getBody() == gInstances[j]) {
-					gInstances.erase(gInstances.begin() + j);
-				}
-			}
-			projectiles.erase(projectiles.begin() + i);
-			i--;
-		}
-		else {
-			if (ProjectileCollide(pTank, projectiles[i])) {
-				pTank.removeHealth(20);
-				for (int j = 0;j < gInstances.size();j++) {
-					if (projectiles[i]->getBody() == gInstances[j]) {
-						gInstances.erase(gInstances.begin() + j);
-					}
-				}
-				projectiles.erase(projectiles.begin() + i);
-				i--;
-			}
-			else if (ProjectileCollide(eTank, projectiles[i])) {
-				eTank.removeHealth(20);
-				for (int j = 0;j < gInstances.size();j++) {
-					if (projectiles[i]->getBody() == gInstances[j]) {
-						gInstances.erase(gInstances.begin() + j);
-					}
-				}
-				projectiles.erase(projectiles.begin() + i);
-				i--;
-			}
-			else if (ProjectileCollide(eTank2, projectiles[i])) {
-				eTank2.removeHealth(20);
-				for (int j = 0;j < gInstances.size();j++) {
-					if (projectiles[i]->getBody() == gInstances[j]) {
-						gInstances.erase(gInstances.begin() + j);
-					}
-				}
-				projectiles.erase(projectiles.begin() + i);
-				i--;
-			}
-		}
-	}
-}
-bool ProjectileCollide(Tank & t, Projectile* projectile){
-	ModelInstance* tankBody = t.GetBody();
-	GLfloat centerX= tankBody->positionX;
-	GLfloat centerY = tankBody->positionY;
-	GLfloat centerZ = tankBody->positionZ;
-
-	GLfloat xzOrientation=t.getXZOrientation();
-	
-	GLfloat sp1X = centerX + glm::sin(glm::radians(xzOrientation));
-	GLfloat sp1Y = centerY;
-	GLfloat sp1Z = centerZ - glm::cos(glm::radians(xzOrientation));
-
-	GLfloat sp2X = centerX - glm::sin(glm::radians(xzOrientation));
-	GLfloat sp2Y = centerY;
-	GLfloat sp2Z = centerZ + glm::cos(glm::radians(xzOrientation));
-
-	GLfloat pX = projectile->getX();
-	GLfloat pY = projectile->getY();
-	GLfloat pZ = projectile->getZ();
-
-	if (distance(sp1X, sp1Y, sp1Z, pX, pY, pZ) <= 1.6 || distance(sp2X, sp2Y, sp2Z, pX, pY, pZ) <= 1.6) {
-		return true;
-	}
-	return false;
-}
-GLfloat distance(GLfloat x, GLfloat y, GLfloat z, GLfloat px, GLfloat py, GLfloat pz) {
-	return sqrt(pow(px - x, 2) + pow(py - y, 2) + pow(pz - z, 2));
-}
-void checkHealth(Tank & t) {
-	if (t.getHealth() <= 0) {
-		if (t.GetBody() == pTank.GetBody()){
-			terminated=true;
-		}
-		else{
-			if (respawnCount > 0) {
-				score += 100;
-				if (t.GetBody() == eTank.GetBody()) {
-					t = Tank(0, 0.5, 120, gTank, gTerrain, gTank, 0);
-					respawnCount--;
-					gInstances[2] = t.GetBody();
-					gInstances[6] = t.GetTurret();
-					gInstances[7] = t.GetCannon();
-				}
-				else {
-					t = Tank(0, 0.5, -120, gTank, gTerrain, gTank, 0);
-					respawnCount--;
-					gInstances[3] = t.GetBody();
-					gInstances[8] = t.GetTurret();
-					gInstances[9] = t.GetCannon();
-				}
-			}
-			else {
-				terminated = true;
-			}
-		}
-	}
-}
-bool isColliding(ModelInstance obstacle, ModelInstance moving) {
-			bool collisionCheck = true;
-			glm::vec3 L;
-			//case1
-			L = moving.Ax;
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case2
-			L = moving.Ay;
-
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case3
-			L = moving.Az;
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case4
-			L = obstacle.Ax;
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case5
-			L = obstacle.Ay;
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case6
-			L = obstacle.Az;
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case7
-			L = glm::cross(moving.Ax, obstacle.Ax);
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case8
-			L = glm::cross(moving.Ax, obstacle.Ay);
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case9
-			L = glm::cross(moving.Ax, obstacle.Az);
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case10
-			L = glm::cross(moving.Ay, obstacle.Ax);
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case11
-			L = glm::cross(moving.Ay, obstacle.Ay);
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case12
-			L = glm::cross(moving.Ay, obstacle.Az);
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case13
-			L = glm::cross(moving.Az, obstacle.Ax);
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-			//case14
-			L = glm::cross(moving.Az, obstacle.Ay);
-			if (OBB(moving, obstacle, L)) {
-
-				collisionCheck = false;
-			}
-
-			L = glm::cross(moving.Az, obstacle.Az);
-			if (OBB(moving, obstacle, L)) {
-				collisionCheck = false;
-			}
-			if (collisionCheck)
-				return true;
-	return false;
-}
-bool OBB(ModelInstance a, ModelInstance b, glm::vec3 L) {
-	glm::vec3 T = a.pos - b.pos;
-	if (glm::dot(T, L) == 0)
-	{
-		return false;
-	}
-	if ((abs(glm::dot(T, L))) > ((abs(glm::dot(multiply(a.size.x, a.Ax), L)) + abs(glm::dot(multiply(a.size.y, a.Ay), L)) + abs(glm::dot(multiply(a.size.z, a.Az), L)) + abs(glm::dot(multiply(b.size.x, b.Ax), L)) + abs(glm::dot(multiply(b.size.y, b.Ay), L)) + abs(glm::dot(multiply(b.size.z, b.Az), L))))) {
-		return true;
-	}
-	else
-
-		return false;
-}
-
 int main(int argc, char *argv[]) {
 	try {
 		AppMain();
-		if (pTank.getHealth() <= 0) {
-			std::cout << "YOU LOSE, SCORE: " << score<< std::endl;
+		if (gWorld.GetPlayer().getHealth() <= 0) {
+			std::cout << "YOU LOSE, SCORE: " << gWorld.score<< std::endl;
 		}
 		else {
-			std::cout << "YOU WIN, SCORE: " << score + pTank.getHealth()*1.5 << std::endl;
+			std::cout << "YOU WIN, SCORE: " << gWorld.score + gWorld.GetPlayer().getHealth()*1.5 << std::endl;
 		}
 		std::cin.ignore();
 		std::cin.get();